@@ -0,0 +1,16 @@
+#version 330 core
+uniform sampler2D impostorAtlas;
+
+in vec2 atlasCoord;
+out vec4 FragColor;
+
+void main()
+{
+	vec4 color = texture(impostorAtlas, atlasCoord);
+
+	// The atlas is cleared with a transparent color, only keep the pixels covered by the Rubik's cube
+	if (color.a < 0.5)
+		discard;
+
+	FragColor = vec4(color.rgb, 1.0);
+}
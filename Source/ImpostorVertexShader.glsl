@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+
+uniform mat4 worldMatrix;
+uniform mat4 viewMatrix = mat4(1.0);
+uniform mat4 projectionMatrix = mat4(1.0);
+uniform vec4 tileRect; // xy = offset of the tile within the atlas, zw = size of the tile
+
+out vec2 atlasCoord;
+
+void main()
+{
+	mat4 modelViewProjection = projectionMatrix * viewMatrix * worldMatrix;
+	gl_Position = modelViewProjection * vec4(aPos, 1.0);
+	atlasCoord = tileRect.xy + aTexCoord * tileRect.zw;
+}
@@ -1,4 +1,5 @@
 #include "cube.h"
+#include "cuberotation.h"
 #include "utils.h"
 
 #define GLEW_STATIC 1
@@ -28,18 +29,22 @@ Cube::Cube(glm::vec3 position)
 	colors.top = yellow;
 	colors.bottom = white;
 
-	this->cubeTransformations.translation = glm::mat4(1.0f);
-	this->cubeTransformations.scaling = glm::mat4(1.0f);
-	this->cubeTransformations.rotation = glm::mat4(1.0f);
-	this->CreateVertexArrayObject();
+	this->translation = glm::mat4(1.0f);
+	this->scaling = glm::mat4(1.0f);
+	this->vao = 0; // Only created by CreateVertexArrayObject, so cubes can be simulated without an OpenGL context
 	this->SetPosition(position);
 	pivot = glm::vec3(0.0f, 0.0f, 0.0f);
+	orientation = CubeRotation::IDENTITY;
+	turnAxis = AXIS_X;
+	turnAngle = 0.0f;
 	isSelected = false;
 }
 
 Cube::~Cube()
 {
-	glDeleteVertexArrays(1, &vao);
+	if (vao != 0) {
+		glDeleteVertexArrays(1, &vao);
+	}
 }
 
 void Cube::CreateVertexArrayObject()
@@ -145,23 +150,13 @@ void Cube::CreateVertexArrayObject()
 	this->vao = vertexArrayObject;
 }
 
-void Cube::Draw(Transformations parentTransformations)
+void Cube::DrawVertexArrayObject(GLuint shader, GLuint vao, glm::mat4 worldMatrix, bool isSelected)
 {
 	glBindVertexArray(vao);
 
-	glm::mat4 cubeTranslationMatrix = cubeTransformations.translation * glm::translate(glm::mat4(1.0f), position);
-
-	glm::vec3 distanceWithGlobalPivot = glm::vec3(1.5f, 1.5f, 1.5f);
-	glm::mat4 parentRotationMatrix = glm::translate(glm::mat4(1.0f), distanceWithGlobalPivot) * parentTransformations.rotation * glm::translate(glm::mat4(1.0f), -distanceWithGlobalPivot);
-
-	glm::mat4 cubeTransformationsMatrix = cubeTranslationMatrix * cubeTransformations.rotation * cubeTransformations.scaling;
-	glm::mat4 parentTransformationsMatrix = parentTransformations.translation * parentRotationMatrix * parentTransformations.scaling;
-
-	glm::mat4 cubeWorldMatrix = parentTransformationsMatrix * cubeTransformationsMatrix;
-
-	SetUniformMat4(shader, "worldMatrix", cubeWorldMatrix);
+	SetUniformMat4(shader, "worldMatrix", worldMatrix);
 
-	if (this->isSelected) {
+	if (isSelected) {
 		SetUniform1Value(shader, "useHighlightColor", true);
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 		SetUniform1Value(shader, "useHighlightColor", false);
@@ -173,6 +168,19 @@ void Cube::Draw(Transformations parentTransformations)
 	glBindVertexArray(0);
 }
 
+glm::mat4 Cube::GetWorldMatrix(Transformations parentTransformations) const
+{
+	glm::mat4 cubeTranslationMatrix = translation * glm::translate(glm::mat4(1.0f), position);
+
+	glm::vec3 distanceWithGlobalPivot = parentTransformations.pivot;
+	glm::mat4 parentRotationMatrix = glm::translate(glm::mat4(1.0f), distanceWithGlobalPivot) * parentTransformations.rotation * glm::translate(glm::mat4(1.0f), -distanceWithGlobalPivot);
+
+	glm::mat4 cubeTransformationsMatrix = cubeTranslationMatrix * GetRotation() * scaling;
+	glm::mat4 parentTransformationsMatrix = parentTransformations.translation * parentRotationMatrix * parentTransformations.scaling;
+
+	return parentTransformationsMatrix * cubeTransformationsMatrix;
+}
+
 void Cube::SetPosition(glm::vec3 position)
 {
 	this->position = position;
@@ -200,17 +208,44 @@ void Cube::SetIsSelected(bool isSelected)
 
 void Cube::SetTranslation(glm::mat4 translation)
 {
-	this->cubeTransformations.translation = translation;
+	this->translation = translation;
 }
 
 void Cube::SetScaling(glm::mat4 scaling)
 {
-	this->cubeTransformations.scaling = scaling;
+	this->scaling = scaling;
+}
+
+void Cube::SetOrientation(int orientation)
+{
+	this->orientation = static_cast<uint8_t>(orientation);
+}
+
+void Cube::SetTurnAngle(CubeAxis axis, float angle)
+{
+	turnAxis = axis;
+	turnAngle = angle;
 }
 
-void Cube::SetRotation(glm::mat4 rotation)
+glm::mat4 Cube::GetRotation() const
 {
-	this->cubeTransformations.rotation = rotation;
+	const int8_t (*matrix)[3] = CubeRotation::GetMatrix(orientation);
+	glm::mat4 rotation = glm::mat4(1.0f);
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			rotation[j][i] = matrix[i][j];
+		}
+	}
+
+	if (turnAngle != 0.0f) {
+		glm::vec3 direction = glm::vec3(0.0f);
+		direction[turnAxis] = 1.0f;
+		rotation = glm::rotate(glm::mat4(1.0f), turnAngle, direction) * rotation;
+	}
+
+	// The pivot calculation is referenced from https://community.khronos.org/t/rotation-at-the-specified-pivot-point/46463
+	glm::vec3 distanceWithPivot = position - pivot;
+	return glm::translate(glm::mat4(1.0f), -distanceWithPivot) * rotation * glm::translate(glm::mat4(1.0f), distanceWithPivot);
 }
 
 void Cube::SetShader(GLuint shader)
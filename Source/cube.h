@@ -1,5 +1,9 @@
 /*
 	The main purpose of this class is to draw an individual cube.
+
+	Once a turn is over, a cube is always in one of the 24 orientations of CubeRotation around its pivot (the center of the Rubik's cube),
+	so its orientation is kept as the index of that rotation and turning it is a lookup in the composition table: it stays exact however
+	many turns are made. A float matrix is only built to draw the cube, on top of which the angle of an in-flight turn is added.
 */
 
 #pragma once
@@ -9,8 +13,11 @@
 #include <GLFW/glfw3.h> 
 #include <glm/glm.hpp>
 
+#include "cuberotation.h"
 #include "utils.h"
 
+#include <cstdint>
+
 class Cube {
 public:
 	Cube(glm::vec3 position);
@@ -21,7 +28,8 @@ public:
 	static const float CUBE_DEPTH;
 
 	void CreateVertexArrayObject();
-	void Draw(Transformations parentTransformations);
+
+	static void DrawVertexArrayObject(GLuint shader, GLuint vao, glm::mat4 worldMatrix, bool isSelected); // Issues the draw call of a cube given its world matrix
 
 	// Setters
 	void SetPosition(glm::vec3 position);
@@ -32,7 +40,9 @@ public:
 
 	void SetTranslation(glm::mat4 translation);
 	void SetScaling(glm::mat4 scaling);
-	void SetRotation(glm::mat4 rotation);
+	void SetOrientation(int orientation); // Resting rotation around the pivot (see CubeRotation)
+	void SetTurnAngle(CubeAxis axis, float angle); // Rotation around the pivot still to go before reaching the orientation (0 at rest)
+	void Turn(int rotation) { orientation = static_cast<uint8_t>(CubeRotation::Compose(rotation, orientation)); } // Turns the resting orientation
 
 	void SetShader(GLuint shader);
 
@@ -42,11 +52,14 @@ public:
 
 	bool GetIsSelected() const { return isSelected; }
 
-	glm::mat4 GetScaling() const { return cubeTransformations.scaling; }
-	glm::mat4 GetTranslation() const { return cubeTransformations.translation; }
-	glm::mat4 GetRotation() const { return cubeTransformations.rotation; }
+	glm::mat4 GetScaling() const { return scaling; }
+	glm::mat4 GetTranslation() const { return translation; }
+	glm::mat4 GetRotation() const; // Rotation around the pivot, expressed around the cube's own origin
+	int GetOrientation() const { return orientation; }
+	glm::mat4 GetWorldMatrix(Transformations parentTransformations) const;
 
 	GLuint GetShader() const { return shader; }
+	GLuint GetVertexArrayObject() const { return vao; }
 
 protected:
 	bool isSelected;
@@ -56,7 +69,13 @@ protected:
 
 	Colors colors;
 
-	Transformations cubeTransformations; // the child transformations to apply on the cube
+	// the child transformations to apply on the cube (the rotation comes from the orientation)
+	glm::mat4 translation;
+	glm::mat4 scaling;
+
+	uint8_t orientation;
+	CubeAxis turnAxis;
+	float turnAngle;
 
 	GLuint shader;
 
@@ -0,0 +1,402 @@
+#include "cubealgorithm.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const char* const FACE_LETTERS = "URFDLB";
+static const char* const WIDE_FACE_LETTERS = "urfdlb";
+static const char* const SLICE_LETTERS = "MES";
+static const char* const ROTATION_LETTERS = "xyz";
+
+static const int MAX_REPETITIONS = 65535;
+
+static int FindLetter(const char* letters, char c)
+{
+	for (int i = 0; letters[i] != '\0'; i++) {
+		if (letters[i] == c) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static bool IsWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static std::vector<CubeAlgorithm> CreateMoveAlgorithms()
+{
+	std::vector<CubeAlgorithm> algorithms;
+	for (int move = 0; move < CubeMoves::NUMBER_OF_MOVES; move++) {
+		algorithms.push_back(CubeAlgorithm(std::vector<uint8_t>(1, static_cast<uint8_t>(move))));
+	}
+
+	return algorithms;
+}
+
+CubeAlgorithm::CubeAlgorithm()
+{
+	length = 0;
+	errorPosition = 0;
+	Compile();
+}
+
+CubeAlgorithm::CubeAlgorithm(const std::vector<uint8_t>& moves)
+{
+	this->moves = moves;
+	length = moves.size();
+	errorPosition = 0;
+	Compile();
+
+	if (length > MAXIMUM_STORED_MOVES) {
+		this->moves.clear();
+	}
+}
+
+CubeAlgorithm::~CubeAlgorithm()
+{
+}
+
+bool CubeAlgorithm::Parse(const std::string& notation)
+{
+	CubeAlgorithm result;
+	size_t position = 0;
+
+	if (!ParseSequence(notation, position, "", 0, result)) {
+		return false;
+	}
+
+	*this = result;
+	error.clear();
+	errorPosition = 0;
+	return true;
+}
+
+bool CubeAlgorithm::ParseSequence(const std::string& notation, size_t& position, const char* terminators, int depth, CubeAlgorithm& result)
+{
+	while (true) {
+		while (position < notation.size() && IsWhitespace(notation[position])) {
+			position++;
+		}
+
+		if (position == notation.size()) {
+			if (terminators[0] != '\0') {
+				return SetError("unexpected end of algorithm", position);
+			}
+			return true;
+		}
+
+		char c = notation[position];
+		if (strchr(terminators, c) != NULL) {
+			return true;
+		}
+
+		if ((c == '(' || c == '[') && depth == MAXIMUM_NESTING_DEPTH) {
+			return SetError("groups nested too deeply", position);
+		}
+
+		if (c == '(') {
+			position++;
+			CubeAlgorithm group;
+			if (!ParseSequence(notation, position, ")", depth + 1, group)) {
+				return false;
+			}
+			position++;
+
+			int count;
+			bool isInverted;
+			if (!ParseSuffix(notation, position, count, isInverted)) {
+				return false;
+			}
+			result.Append((isInverted ? group.Inverse() : group).Repeat(count));
+		}
+		else if (c == '[') {
+			// Commutator [A, B] or conjugate [A: B]
+			position++;
+			CubeAlgorithm first, second;
+			if (!ParseSequence(notation, position, ",:", depth + 1, first)) {
+				return false;
+			}
+
+			bool isCommutator = notation[position] == ',';
+			position++;
+			if (!ParseSequence(notation, position, "]", depth + 1, second)) {
+				return false;
+			}
+			position++;
+
+			CubeAlgorithm group = first + second;
+			group.Append(first.Inverse());
+			if (isCommutator) {
+				group.Append(second.Inverse());
+			}
+
+			int count;
+			bool isInverted;
+			if (!ParseSuffix(notation, position, count, isInverted)) {
+				return false;
+			}
+			result.Append((isInverted ? group.Inverse() : group).Repeat(count));
+		}
+		else if (strchr(")],:", c) != NULL) {
+			return SetError("unmatched bracket or separator", position);
+		}
+		else if (!ParseMove(notation, position, result)) {
+			return false;
+		}
+	}
+}
+
+bool CubeAlgorithm::ParseMove(const std::string& notation, size_t& position, CubeAlgorithm& result)
+{
+	char c = notation[position];
+	int family;
+
+	if ((family = FindLetter(FACE_LETTERS, c)) >= 0) {
+		if (position + 1 < notation.size() && notation[position + 1] == 'w') {
+			family += CubeMoves::UW;
+			position++;
+		}
+	}
+	else if ((family = FindLetter(WIDE_FACE_LETTERS, c)) >= 0) {
+		family += CubeMoves::UW;
+	}
+	else if ((family = FindLetter(SLICE_LETTERS, c)) >= 0) {
+		family += CubeMoves::M;
+	}
+	else if ((family = FindLetter(ROTATION_LETTERS, c)) >= 0) {
+		family += CubeMoves::X;
+	}
+	else {
+		return SetError("unknown move", position);
+	}
+	position++;
+
+	int count;
+	bool isInverted;
+	if (!ParseSuffix(notation, position, count, isInverted)) {
+		return false;
+	}
+
+	int quarterTurns = (isInverted ? -count : count) & 3;
+	if (quarterTurns != 0) {
+		result.Append(GetMoveAlgorithm(CubeMoves::GetMove(static_cast<CubeMoves::Family>(family), quarterTurns)));
+	}
+
+	return true;
+}
+
+bool CubeAlgorithm::ParseSuffix(const std::string& notation, size_t& position, int& count, bool& isInverted)
+{
+	// A count and a prime, in either order (R2', R'2)
+	isInverted = false;
+	if (position < notation.size() && notation[position] == '\'') {
+		isInverted = true;
+		position++;
+	}
+
+	size_t countPosition = position;
+	count = 0;
+	while (position < notation.size() && notation[position] >= '0' && notation[position] <= '9') {
+		count = count * 10 + (notation[position] - '0');
+		position++;
+
+		if (count > MAX_REPETITIONS) {
+			return SetError("repetition count too large", countPosition);
+		}
+	}
+	if (position == countPosition) {
+		count = 1;
+	}
+
+	if (!isInverted && position < notation.size() && notation[position] == '\'') {
+		isInverted = true;
+		position++;
+	}
+
+	return true;
+}
+
+bool CubeAlgorithm::SetError(const char* message, size_t position)
+{
+	error = message;
+	errorPosition = position;
+	return false;
+}
+
+const CubeAlgorithm& CubeAlgorithm::GetMoveAlgorithm(int move)
+{
+	static const std::vector<CubeAlgorithm> algorithms = CreateMoveAlgorithms();
+	return algorithms[move];
+}
+
+void CubeAlgorithm::Compile()
+{
+	rotation = CubeRotation::IDENTITY;
+	for (size_t i = 0; i < moves.size(); i++) {
+		if (CubeMoves::GetFamily(moves[i]) >= CubeMoves::X) {
+			LayerTurns turns = CubeMoves::GetLayerTurns(moves[i]);
+			rotation = static_cast<uint8_t>(CubeRotation::Compose(CubeRotation::FromAxis(turns.axis, turns.layers[1]), rotation));
+		}
+	}
+
+	// Run the moves on a solved cube in each frame: the piece found in each slot is where that slot takes its piece from
+	for (int frame = 0; frame < CubeRotation::NUMBER_OF_ROTATIONS; frame++) {
+		CubeState state;
+		state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+		for (size_t i = 0; i < moves.size(); i++) {
+			state.ApplyMove(moves[i]);
+		}
+
+		MoveEngine::FacePairTurn& permutation = permutations[frame];
+		for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+			bool isEdge = i >= CubeState::EDGE_OFFSET && i < CubeState::EDGE_OFFSET + CubeState::NUMBER_OF_EDGES;
+			bool isCorner = i >= CubeState::CORNER_OFFSET && i < CubeState::CORNER_OFFSET + CubeState::NUMBER_OF_CORNERS;
+
+			if (isEdge || isCorner) {
+				permutation.shuffle[i] = state.bytes[i] & CubeState::PIECE_MASK;
+				permutation.twist[i] = state.bytes[i] & ~CubeState::PIECE_MASK;
+			}
+			else {
+				permutation.shuffle[i] = i & 15;
+				permutation.twist[i] = 0;
+			}
+		}
+
+		finalFrames[frame] = static_cast<uint8_t>(state.GetFrame());
+	}
+}
+
+void CubeAlgorithm::Apply(CubeState& state) const
+{
+	int frame = state.GetFrame();
+	const MoveEngine::FacePairTurn& permutation = permutations[frame];
+
+	uint8_t result[CubeState::STATE_SIZE];
+	for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+		result[i] = state.bytes[(i & 16) + permutation.shuffle[i]] + permutation.twist[i];
+	}
+
+	CubeState::ReduceOrientations(result);
+
+	result[CubeState::FRAME_OFFSET] = finalFrames[frame];
+	memcpy(state.bytes, result, CubeState::STATE_SIZE);
+}
+
+CubeAlgorithm CubeAlgorithm::Inverse() const
+{
+	CubeAlgorithm inverse;
+	for (size_t i = moves.size(); i > 0; i--) {
+		inverse.moves.push_back(static_cast<uint8_t>(CubeMoves::Inverse(moves[i - 1])));
+	}
+	inverse.length = length;
+	inverse.rotation = static_cast<uint8_t>(CubeRotation::Inverse(rotation));
+
+	// A cube in frame f ends up in finalFrames[f], so the inverse takes a cube in that frame back to f, sending every piece back to the
+	// slot it came from with the opposite twist
+	for (int frame = 0; frame < CubeRotation::NUMBER_OF_ROTATIONS; frame++) {
+		const MoveEngine::FacePairTurn& permutation = permutations[frame];
+		MoveEngine::FacePairTurn& inversePermutation = inverse.permutations[finalFrames[frame]];
+
+		for (int i = CubeState::EDGE_OFFSET; i < CubeState::EDGE_OFFSET + CubeState::NUMBER_OF_EDGES; i++) {
+			int source = CubeState::EDGE_OFFSET + permutation.shuffle[i];
+			inversePermutation.shuffle[source] = static_cast<uint8_t>(i & 15);
+			inversePermutation.twist[source] = permutation.twist[i];
+		}
+		for (int i = CubeState::CORNER_OFFSET; i < CubeState::CORNER_OFFSET + CubeState::NUMBER_OF_CORNERS; i++) {
+			int source = CubeState::CORNER_OFFSET + permutation.shuffle[i];
+			inversePermutation.shuffle[source] = static_cast<uint8_t>(i & 15);
+			inversePermutation.twist[source] = static_cast<uint8_t>(permutation.twist[i] == 0 ? 0 : (3 << CubeState::ORIENTATION_SHIFT) - permutation.twist[i]);
+		}
+
+		inverse.finalFrames[finalFrames[frame]] = static_cast<uint8_t>(frame);
+	}
+
+	return inverse;
+}
+
+CubeAlgorithm CubeAlgorithm::Repeat(int count) const
+{
+	// Repeated squaring: base goes through the algorithm applied 1, 2, 4... times
+	CubeAlgorithm result;
+	CubeAlgorithm base = *this;
+	while (count > 0) {
+		if (count & 1) {
+			result.Append(base);
+		}
+
+		count >>= 1;
+		if (count > 0) {
+			base.Append(base);
+		}
+	}
+
+	return result;
+}
+
+CubeAlgorithm CubeAlgorithm::operator+(const CubeAlgorithm& other) const
+{
+	CubeAlgorithm sum = *this;
+	sum.Append(other);
+	return sum;
+}
+
+void CubeAlgorithm::Append(const CubeAlgorithm& other)
+{
+	if (&other == this) {
+		CubeAlgorithm copy = other;
+		Append(copy);
+		return;
+	}
+
+	// A cube in frame f is turned by this algorithm's permutation for f, then by the other's for the frame it is left in
+	for (int frame = 0; frame < CubeRotation::NUMBER_OF_ROTATIONS; frame++) {
+		MoveEngine::FacePairTurn& permutation = permutations[frame];
+		const MoveEngine::FacePairTurn& next = other.permutations[finalFrames[frame]];
+
+		MoveEngine::FacePairTurn composed;
+		for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+			int source = (i & 16) + next.shuffle[i];
+			composed.shuffle[i] = permutation.shuffle[source];
+			composed.twist[i] = static_cast<uint8_t>(permutation.twist[source] + next.twist[i]);
+		}
+
+		CubeState::ReduceOrientations(composed.twist);
+
+		permutation = composed;
+		finalFrames[frame] = other.finalFrames[finalFrames[frame]];
+	}
+
+	rotation = static_cast<uint8_t>(CubeRotation::Compose(other.rotation, rotation));
+
+	// Moves are only kept while they fit, the compiled form is all that applying the algorithm needs
+	uint64_t sumLength = other.length > UINT64_MAX - length ? UINT64_MAX : length + other.length;
+	if (sumLength <= MAXIMUM_STORED_MOVES) {
+		moves.insert(moves.end(), other.moves.begin(), other.moves.end());
+	}
+	else {
+		std::vector<uint8_t>().swap(moves);
+	}
+	length = sumLength;
+}
+
+std::string CubeAlgorithm::ToString() const
+{
+	std::string result;
+	for (size_t i = 0; i < moves.size(); i++) {
+		if (i > 0) {
+			result += ' ';
+		}
+		result += CubeMoves::GetName(moves[i]);
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/*
+	The main purpose of this class is to turn an algorithm written in the standard notation into a single permutation of the cube, so
+	that applying it costs the same as applying one move, whatever its length.
+
+	Supported notation: face turns (U R F D L B), wide turns (Uw or u, ...), slices (M E S) and rotations (x y z), each followed by
+	an optional count and/or prime (R2, U', R2', U3). Parentheses group moves and can be repeated or inverted as a whole
+	((R U R' U')6, (R U)'), and [A, B] and [A: B] stand for the commutator A B A' B' and the conjugate A B A'.
+
+	Moves are seen from the world, so the effect of an algorithm on the pieces depends on the frame of the cube it is applied to
+	(see CubeState). The algorithm is compiled once for each of the 24 frames, as a byte shuffle and an orientation change in the
+	packed CubeState layout (the same form as a MoveEngine::FacePairTurn) plus the frame the cube ends up in.
+
+	Parsing works on those compiled forms directly: a group is the composition of its parts, inverting it inverts the permutations, and a
+	repeated group is raised to its count by repeated squaring. ((R U)65535)65535 costs a few dozen compositions instead of 8.6 billion
+	moves. The list of moves is only kept while it has at most MAXIMUM_STORED_MOVES moves, GetLength still counts the moves of longer
+	algorithms.
+*/
+
+#pragma once
+
+#include "cuberotation.h"
+#include "cubestate.h"
+#include "moveengine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CubeAlgorithm {
+public:
+	static const size_t MAXIMUM_STORED_MOVES = 1 << 16;
+	static const int MAXIMUM_NESTING_DEPTH = 100; // Groups and brackets inside each other, each level of the parser holds a few algorithms on the stack
+
+	CubeAlgorithm(); // The empty algorithm
+	CubeAlgorithm(const std::vector<uint8_t>& moves); // Moves of the standard notation (see CubeMoves)
+	virtual ~CubeAlgorithm();
+
+	// Replaces the algorithm with the parsed notation. On failure the algorithm is left unchanged, and GetError and GetErrorPosition
+	// describe the problem.
+	bool Parse(const std::string& notation);
+
+	void Apply(CubeState& state) const;
+
+	CubeAlgorithm Inverse() const;
+	CubeAlgorithm Repeat(int count) const; // The algorithm applied count times
+	CubeAlgorithm operator+(const CubeAlgorithm& other) const; // This algorithm followed by the other one
+	void Append(const CubeAlgorithm& other); // Same, in place
+
+	std::string ToString() const; // The moves of the algorithm separated by spaces, with groups expanded (empty if they are not stored)
+
+	// Getters
+	const std::vector<uint8_t>& GetMoves() const { return moves; } // Empty when the algorithm is longer than MAXIMUM_STORED_MOVES
+	uint64_t GetLength() const { return length; } // Number of moves once expanded, saturating at the largest uint64_t
+	int GetRotation() const { return rotation; } // Composition of the whole cube rotations (x, y, z) of the algorithm, in the world
+
+	// Effect on the pieces of a cube in each frame, and frame of the cube after the algorithm, indexed by the frame before it
+	const MoveEngine::FacePairTurn* GetPermutations() const { return permutations; }
+	const uint8_t* GetFinalFrames() const { return finalFrames; }
+
+	const std::string& GetError() const { return error; }
+	size_t GetErrorPosition() const { return errorPosition; }
+
+protected:
+	std::vector<uint8_t> moves;
+	uint64_t length;
+	uint8_t rotation;
+
+	MoveEngine::FacePairTurn permutations[CubeRotation::NUMBER_OF_ROTATIONS];
+	uint8_t finalFrames[CubeRotation::NUMBER_OF_ROTATIONS];
+
+	std::string error;
+	size_t errorPosition;
+
+	void Compile();
+
+	// Recursive descent over the notation, stopping at the end of the text or at one of the terminators (which is not consumed). depth
+	// counts the groups the sequence is in.
+	bool ParseSequence(const std::string& notation, size_t& position, const char* terminators, int depth, CubeAlgorithm& result);
+	bool ParseMove(const std::string& notation, size_t& position, CubeAlgorithm& result);
+	bool ParseSuffix(const std::string& notation, size_t& position, int& count, bool& isInverted);
+	bool SetError(const char* message, size_t position);
+
+	static const CubeAlgorithm& GetMoveAlgorithm(int move); // Each move compiled once, on first use
+};
\ No newline at end of file
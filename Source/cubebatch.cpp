@@ -0,0 +1,300 @@
+#include "cubebatch.h"
+#include "cubealgorithm.h"
+#include "cubemoves.h"
+#include "cubestate.h"
+#include "moveengine.h"
+#include "simd.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct CubeBatchKernels {
+	static void TwistScalar(uint8_t* destination, const uint8_t* source, size_t count, uint8_t twist, uint8_t modulus)
+	{
+		for (size_t i = 0; i < count; i++) {
+			uint8_t value = source[i] + twist;
+			uint8_t reduced = value - modulus;
+			destination[i] = reduced < value ? reduced : value;
+		}
+	}
+
+#if defined(SIMD_X86)
+	TARGET_SSE2 static void TwistSse2(uint8_t* destination, const uint8_t* source, size_t count, uint8_t twist, uint8_t modulus)
+	{
+		const __m128i twists = _mm_set1_epi8(static_cast<char>(twist));
+		const __m128i moduli = _mm_set1_epi8(static_cast<char>(modulus));
+
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16) {
+			__m128i value = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)), twists);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_min_epu8(value, _mm_sub_epi8(value, moduli)));
+		}
+
+		TwistScalar(destination + i, source + i, count - i, twist, modulus);
+	}
+
+	TARGET_AVX2 static void TwistAvx2(uint8_t* destination, const uint8_t* source, size_t count, uint8_t twist, uint8_t modulus)
+	{
+		const __m256i twists = _mm256_set1_epi8(static_cast<char>(twist));
+		const __m256i moduli = _mm256_set1_epi8(static_cast<char>(modulus));
+
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32) {
+			__m256i value = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i)), twists);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_min_epu8(value, _mm256_sub_epi8(value, moduli)));
+		}
+
+		TwistScalar(destination + i, source + i, count - i, twist, modulus);
+	}
+#endif
+};
+
+CubeBatch::CubeBatch(size_t numberOfStates)
+{
+	Initialize(numberOfStates, MoveEngine::DetectInstructionSet());
+}
+
+CubeBatch::CubeBatch(size_t numberOfStates, MoveEngine::InstructionSet instructionSet)
+{
+	MoveEngine::InstructionSet supportedInstructionSet = MoveEngine::DetectInstructionSet();
+	Initialize(numberOfStates, instructionSet < supportedInstructionSet ? instructionSet : supportedInstructionSet);
+}
+
+CubeBatch::~CubeBatch()
+{
+	StopWorkers();
+}
+
+void CubeBatch::Initialize(size_t numberOfStates, MoveEngine::InstructionSet instructionSet)
+{
+	this->numberOfStates = numberOfStates;
+	this->instructionSet = instructionSet;
+	statesPerSecond = 0.0;
+
+	workAlgorithm = nullptr;
+	workBlocks = 0;
+	workThreads = 0;
+	pendingWorkers = 0;
+	workGeneration = 0;
+	isStopping = false;
+
+	twistKernel = CubeBatchKernels::TwistScalar;
+#if defined(SIMD_X86)
+	if (instructionSet == MoveEngine::SSSE3) {
+		twistKernel = CubeBatchKernels::TwistSse2;
+	}
+	else if (instructionSet == MoveEngine::AVX2) {
+		twistKernel = CubeBatchKernels::TwistAvx2;
+	}
+#endif
+
+	numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+	if (numberOfThreads < 1) {
+		numberOfThreads = 1;
+	}
+
+	CubeState solvedState;
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		slots[slot].assign(numberOfStates, solvedState.bytes[GetStateIndex(slot)]);
+	}
+	frames.assign(numberOfStates, static_cast<uint8_t>(solvedState.GetFrame()));
+
+	for (int move = 0; move < CubeMoves::NUMBER_OF_MOVES; move++) {
+		moveAlgorithms.push_back(CubeAlgorithm(std::vector<uint8_t>(1, static_cast<uint8_t>(move))));
+	}
+}
+
+void CubeBatch::Apply(int move)
+{
+	Apply(moveAlgorithms[move]);
+}
+
+void CubeBatch::Apply(const CubeAlgorithm& algorithm)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Give each thread a contiguous run of blocks, and keep the last one for the calling thread
+	size_t numberOfBlocks = (numberOfStates + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	size_t numberOfWorkers = numberOfThreads < 1 ? 1 : static_cast<size_t>(numberOfThreads);
+	if (numberOfWorkers > numberOfBlocks / MINIMUM_BLOCKS_PER_THREAD) {
+		numberOfWorkers = numberOfBlocks / MINIMUM_BLOCKS_PER_THREAD > 0 ? numberOfBlocks / MINIMUM_BLOCKS_PER_THREAD : 1;
+	}
+
+	if (numberOfWorkers == 1) {
+		ApplyBlocks(algorithm, 0, numberOfBlocks);
+	}
+	else {
+		StartWorkers(numberOfWorkers - 1);
+
+		{
+			std::lock_guard<std::mutex> lock(workMutex);
+			workAlgorithm = &algorithm;
+			workBlocks = numberOfBlocks;
+			workThreads = numberOfWorkers;
+			pendingWorkers = numberOfWorkers - 1;
+			workGeneration++;
+		}
+		workReady.notify_all();
+
+		ApplyBlocks(algorithm, numberOfBlocks * (numberOfWorkers - 1) / numberOfWorkers, numberOfBlocks);
+
+		std::unique_lock<std::mutex> lock(workMutex);
+		while (pendingWorkers > 0) {
+			workDone.wait(lock);
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	statesPerSecond = seconds > 0.0 ? numberOfStates / seconds : 0.0;
+}
+
+void CubeBatch::ApplyBlocks(const CubeAlgorithm& algorithm, size_t firstBlock, size_t endBlock)
+{
+	const MoveEngine::FacePairTurn* permutations = algorithm.GetPermutations();
+	const uint8_t* finalFrames = algorithm.GetFinalFrames();
+
+	uint8_t turnedSlots[NUMBER_OF_SLOTS][BLOCK_SIZE];
+
+	for (size_t block = firstBlock; block < endBlock; block++) {
+		size_t begin = block * BLOCK_SIZE;
+		size_t count = numberOfStates - begin < static_cast<size_t>(BLOCK_SIZE) ? numberOfStates - begin : BLOCK_SIZE;
+
+		uint8_t frame = frames[begin];
+		bool isSingleFrame = true;
+		for (size_t i = 1; i < count; i++) {
+			isSingleFrame &= frames[begin + i] == frame;
+		}
+
+		if (!isSingleFrame) {
+			for (size_t i = begin; i < begin + count; i++) {
+				CubeState state = GetState(i);
+				algorithm.Apply(state);
+				SetState(i, state);
+			}
+			continue;
+		}
+
+		// Every state of the block takes the pieces of the same source slots: turn whole arrays, then copy them back
+		const MoveEngine::FacePairTurn& permutation = permutations[frame];
+		for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+			int index = GetStateIndex(slot);
+			int sourceIndex = (index & 16) + permutation.shuffle[index];
+			int sourceSlot = sourceIndex < CubeState::CORNER_OFFSET ? sourceIndex - CubeState::EDGE_OFFSET : CubeState::NUMBER_OF_EDGES + sourceIndex - CubeState::CORNER_OFFSET;
+			uint8_t modulus = static_cast<uint8_t>((slot < CubeState::NUMBER_OF_EDGES ? 2 : 3) << CubeState::ORIENTATION_SHIFT);
+
+			twistKernel(turnedSlots[slot], slots[sourceSlot].data() + begin, count, permutation.twist[index], modulus);
+		}
+
+		for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+			memcpy(slots[slot].data() + begin, turnedSlots[slot], count);
+		}
+		memset(frames.data() + begin, finalFrames[frame], count);
+	}
+}
+
+void CubeBatch::SetState(size_t index, const CubeState& state)
+{
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		slots[slot][index] = state.bytes[GetStateIndex(slot)];
+	}
+	frames[index] = static_cast<uint8_t>(state.GetFrame());
+}
+
+CubeState CubeBatch::GetState(size_t index) const
+{
+	CubeState state;
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		state.bytes[GetStateIndex(slot)] = slots[slot][index];
+	}
+	state.bytes[CubeState::FRAME_OFFSET] = frames[index];
+	state.UpdateInvariants();
+
+	return state;
+}
+
+size_t CubeBatch::CountSolved() const
+{
+	// A state is solved when every slot holds its own piece, unturned
+	std::vector<uint8_t> isSolved(numberOfStates, 1);
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		uint8_t solvedValue = CubeState::SOLVED_BYTES[GetStateIndex(slot)];
+		const uint8_t* values = slots[slot].data();
+		for (size_t i = 0; i < numberOfStates; i++) {
+			isSolved[i] &= values[i] == solvedValue;
+		}
+	}
+
+	size_t count = 0;
+	for (size_t i = 0; i < numberOfStates; i++) {
+		count += isSolved[i];
+	}
+
+	return count;
+}
+
+void CubeBatch::StartWorkers(size_t numberOfWorkers)
+{
+	while (workers.size() < numberOfWorkers) {
+		workers.push_back(std::thread(&CubeBatch::RunWorker, this, workers.size(), workGeneration));
+	}
+}
+
+void CubeBatch::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(workMutex);
+		isStopping = true;
+	}
+	workReady.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+	workers.clear();
+}
+
+void CubeBatch::RunWorker(size_t index, uint64_t generation)
+{
+	std::unique_lock<std::mutex> lock(workMutex);
+
+	while (true) {
+		while (!isStopping && workGeneration == generation) {
+			workReady.wait(lock);
+		}
+		if (isStopping) {
+			return;
+		}
+		generation = workGeneration;
+
+		// Workers past the threads of the job sit this one out
+		if (index + 1 < workThreads) {
+			const CubeAlgorithm& algorithm = *workAlgorithm;
+			size_t firstBlock = workBlocks * index / workThreads;
+			size_t endBlock = workBlocks * (index + 1) / workThreads;
+
+			lock.unlock();
+			ApplyBlocks(algorithm, firstBlock, endBlock);
+			lock.lock();
+
+			if (--pendingWorkers == 0) {
+				workDone.notify_one();
+			}
+		}
+	}
+}
+
+void CubeBatch::SetNumberOfThreads(int numberOfThreads)
+{
+	this->numberOfThreads = numberOfThreads < 1 ? 1 : numberOfThreads;
+}
+
+int CubeBatch::GetStateIndex(int slot)
+{
+	return slot < CubeState::NUMBER_OF_EDGES ? CubeState::EDGE_OFFSET + slot : CubeState::CORNER_OFFSET + slot - CubeState::NUMBER_OF_EDGES;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+	The main purpose of this class is to hold millions of CubeStates for analysis jobs and turn all of them at once. It has no OpenGL
+	dependency, so it can run headless.
+
+	States are stored as a structure of arrays: one contiguous byte array per piece slot (12 edges, then 8 corners) and one for the
+	frames. Within a block of states sharing the same frame, a move or compiled algorithm is the same permutation for every state, so
+	it comes down to picking source arrays and running a vector add/min over each of them. Blocks mixing several frames fall back to
+	turning each state on its own.
+
+	Blocks are spread over a pool of worker threads, started the first time they are needed and kept until the batch is destroyed, so
+	applying moves one after another only wakes them up. A thread is only woken for at least MINIMUM_BLOCKS_PER_THREAD blocks, smaller
+	batches are turned on the calling thread.
+*/
+
+#pragma once
+
+#include "cubealgorithm.h"
+#include "cubestate.h"
+#include "moveengine.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CubeBatch {
+public:
+	static const int NUMBER_OF_SLOTS = CubeState::NUMBER_OF_EDGES + CubeState::NUMBER_OF_CORNERS;
+	static const int BLOCK_SIZE = 256; // States processed together by one worker, all arrays of a block fit in the L1 cache
+	static const int MINIMUM_BLOCKS_PER_THREAD = 16; // Less work than this does not pay for waking a thread up
+
+	CubeBatch(size_t numberOfStates); // Solved cubes in the identity frame, using the best instruction set supported by the CPU
+	CubeBatch(size_t numberOfStates, MoveEngine::InstructionSet instructionSet);
+	virtual ~CubeBatch();
+
+	void Apply(int move); // Applies a move of the standard notation (see CubeMoves) to every state
+	void Apply(const CubeAlgorithm& algorithm);
+
+	void SetState(size_t index, const CubeState& state);
+	CubeState GetState(size_t index) const; // The invariants (see CubeState) are not stored, they are computed again
+
+	size_t CountSolved() const;
+
+	// Setters
+	void SetNumberOfThreads(int numberOfThreads); // Including the calling thread
+
+	// Getters
+	size_t GetNumberOfStates() const { return numberOfStates; }
+	int GetNumberOfThreads() const { return numberOfThreads; }
+	MoveEngine::InstructionSet GetInstructionSet() const { return instructionSet; }
+
+	double GetStatesPerSecond() const { return statesPerSecond; } // Throughput of the last Apply
+
+	// Pieces and orientations (packed as in CubeState) of a slot for every state
+	const uint8_t* GetSlot(int slot) const { return slots[slot].data(); }
+	uint8_t* GetSlot(int slot) { return slots[slot].data(); }
+	const uint8_t* GetFrames() const { return frames.data(); }
+
+protected:
+	// Computes destination[i] = source[i] + twist, with the orientation brought back in range by the modulus (see MoveEngine)
+	typedef void (*TwistKernel)(uint8_t* destination, const uint8_t* source, size_t count, uint8_t twist, uint8_t modulus);
+
+	size_t numberOfStates;
+	int numberOfThreads;
+
+	MoveEngine::InstructionSet instructionSet;
+	TwistKernel twistKernel;
+
+	std::vector<uint8_t> slots[NUMBER_OF_SLOTS];
+	std::vector<uint8_t> frames;
+
+	std::vector<CubeAlgorithm> moveAlgorithms; // Each move compiled as an algorithm
+
+	double statesPerSecond;
+
+	// Pool of worker threads, the calling thread being the last worker of every job
+	std::vector<std::thread> workers;
+	std::mutex workMutex;
+	std::condition_variable workReady;
+	std::condition_variable workDone;
+	const CubeAlgorithm* workAlgorithm;
+	size_t workBlocks; // Blocks of the current job
+	size_t workThreads; // Threads sharing the current job, including the calling thread
+	size_t pendingWorkers; // Workers of the current job that are not done yet
+	uint64_t workGeneration; // Incremented for every job, so a worker sees new work
+	bool isStopping;
+
+	void Initialize(size_t numberOfStates, MoveEngine::InstructionSet instructionSet);
+	void ApplyBlocks(const CubeAlgorithm& algorithm, size_t firstBlock, size_t endBlock); // Work done by one thread
+
+	void StartWorkers(size_t numberOfWorkers); // Grows the pool to at least numberOfWorkers threads
+	void StopWorkers();
+	void RunWorker(size_t index, uint64_t generation); // Body of a worker thread, generation being the last job done before it started
+
+	static int GetStateIndex(int slot); // Byte of the packed CubeState layout holding a slot
+
+	friend struct CubeBatchKernels;
+};
\ No newline at end of file
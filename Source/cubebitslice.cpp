@@ -0,0 +1,374 @@
+#include "cubebitslice.h"
+#include "cubealgorithm.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+#include "moveengine.h"
+#include "simd.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static const int SLOT_WORDS = CubeBitslice::PLANES_PER_SLOT * CubeBitslice::WORDS_PER_PLANE;
+
+static int CountBits(uint64_t word)
+{
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+}
+
+struct CubeBitsliceKernels {
+	// Planes 0 to 2 always hold piece bits. Plane 3 is the last piece bit of an edge, or the low twist bit of a corner, and plane 4 the
+	// flip of an edge, or the high twist bit of a corner. Adding 1 to a twist (o1, o0) gives (o0, !(o0 | o1)), and adding 2 gives
+	// (!(o0 | o1), o1).
+	static void TurnScalar(const CubeBitslice::SlotTurn& turn, const uint64_t* source, uint64_t* destination)
+	{
+		for (int slot = 0; slot < CubeBitslice::NUMBER_OF_SLOTS; slot++) {
+			const uint64_t* from = source + turn.sourceSlots[slot] * SLOT_WORDS;
+			uint64_t* to = destination + slot * SLOT_WORDS;
+			int twist = turn.twists[slot];
+			bool isCorner = slot >= CubeState::NUMBER_OF_EDGES;
+
+			for (int word = 0; word < CubeBitslice::WORDS_PER_PLANE; word++) {
+				uint64_t plane3 = from[3 * CubeBitslice::WORDS_PER_PLANE + word];
+				uint64_t plane4 = from[4 * CubeBitslice::WORDS_PER_PLANE + word];
+
+				if (!isCorner) {
+					plane4 ^= twist != 0 ? ~0ULL : 0ULL;
+				}
+				else if (twist == 1) {
+					uint64_t zero = ~(plane3 | plane4);
+					plane4 = plane3;
+					plane3 = zero;
+				}
+				else if (twist == 2) {
+					uint64_t zero = ~(plane3 | plane4);
+					plane3 = plane4;
+					plane4 = zero;
+				}
+
+				to[word] = from[word];
+				to[CubeBitslice::WORDS_PER_PLANE + word] = from[CubeBitslice::WORDS_PER_PLANE + word];
+				to[2 * CubeBitslice::WORDS_PER_PLANE + word] = from[2 * CubeBitslice::WORDS_PER_PLANE + word];
+				to[3 * CubeBitslice::WORDS_PER_PLANE + word] = plane3;
+				to[4 * CubeBitslice::WORDS_PER_PLANE + word] = plane4;
+			}
+		}
+	}
+
+#if defined(SIMD_X86)
+	TARGET_SSE2 static void TurnSse2(const CubeBitslice::SlotTurn& turn, const uint64_t* source, uint64_t* destination)
+	{
+		const __m128i ones = _mm_set1_epi32(-1);
+
+		for (int slot = 0; slot < CubeBitslice::NUMBER_OF_SLOTS; slot++) {
+			const __m128i* from = reinterpret_cast<const __m128i*>(source + turn.sourceSlots[slot] * SLOT_WORDS);
+			__m128i* to = reinterpret_cast<__m128i*>(destination + slot * SLOT_WORDS);
+			int twist = turn.twists[slot];
+			bool isCorner = slot >= CubeState::NUMBER_OF_EDGES;
+
+			// Each plane is two registers
+			for (int half = 0; half < 2; half++) {
+				__m128i plane3 = _mm_loadu_si128(from + 6 + half);
+				__m128i plane4 = _mm_loadu_si128(from + 8 + half);
+
+				if (!isCorner) {
+					plane4 = twist != 0 ? _mm_xor_si128(plane4, ones) : plane4;
+				}
+				else if (twist == 1) {
+					__m128i zero = _mm_xor_si128(_mm_or_si128(plane3, plane4), ones);
+					plane4 = plane3;
+					plane3 = zero;
+				}
+				else if (twist == 2) {
+					__m128i zero = _mm_xor_si128(_mm_or_si128(plane3, plane4), ones);
+					plane3 = plane4;
+					plane4 = zero;
+				}
+
+				_mm_storeu_si128(to + half, _mm_loadu_si128(from + half));
+				_mm_storeu_si128(to + 2 + half, _mm_loadu_si128(from + 2 + half));
+				_mm_storeu_si128(to + 4 + half, _mm_loadu_si128(from + 4 + half));
+				_mm_storeu_si128(to + 6 + half, plane3);
+				_mm_storeu_si128(to + 8 + half, plane4);
+			}
+		}
+	}
+
+	TARGET_AVX2 static void TurnAvx2(const CubeBitslice::SlotTurn& turn, const uint64_t* source, uint64_t* destination)
+	{
+		const __m256i ones = _mm256_set1_epi32(-1);
+
+		for (int slot = 0; slot < CubeBitslice::NUMBER_OF_SLOTS; slot++) {
+			const __m256i* from = reinterpret_cast<const __m256i*>(source + turn.sourceSlots[slot] * SLOT_WORDS);
+			__m256i* to = reinterpret_cast<__m256i*>(destination + slot * SLOT_WORDS);
+			int twist = turn.twists[slot];
+			bool isCorner = slot >= CubeState::NUMBER_OF_EDGES;
+
+			__m256i plane3 = _mm256_loadu_si256(from + 3);
+			__m256i plane4 = _mm256_loadu_si256(from + 4);
+
+			if (!isCorner) {
+				plane4 = twist != 0 ? _mm256_xor_si256(plane4, ones) : plane4;
+			}
+			else if (twist == 1) {
+				__m256i zero = _mm256_xor_si256(_mm256_or_si256(plane3, plane4), ones);
+				plane4 = plane3;
+				plane3 = zero;
+			}
+			else if (twist == 2) {
+				__m256i zero = _mm256_xor_si256(_mm256_or_si256(plane3, plane4), ones);
+				plane3 = plane4;
+				plane4 = zero;
+			}
+
+			_mm256_storeu_si256(to, _mm256_loadu_si256(from));
+			_mm256_storeu_si256(to + 1, _mm256_loadu_si256(from + 1));
+			_mm256_storeu_si256(to + 2, _mm256_loadu_si256(from + 2));
+			_mm256_storeu_si256(to + 3, plane3);
+			_mm256_storeu_si256(to + 4, plane4);
+		}
+	}
+#endif
+};
+
+CubeBitslice::CubeBitslice(size_t numberOfStates)
+{
+	Initialize(numberOfStates, MoveEngine::DetectInstructionSet());
+}
+
+CubeBitslice::CubeBitslice(size_t numberOfStates, MoveEngine::InstructionSet instructionSet)
+{
+	MoveEngine::InstructionSet supportedInstructionSet = MoveEngine::DetectInstructionSet();
+	Initialize(numberOfStates, instructionSet < supportedInstructionSet ? instructionSet : supportedInstructionSet);
+}
+
+CubeBitslice::~CubeBitslice()
+{
+}
+
+void CubeBitslice::Initialize(size_t numberOfStates, MoveEngine::InstructionSet instructionSet)
+{
+	this->numberOfStates = numberOfStates;
+	this->instructionSet = instructionSet;
+	numberOfBlocks = (numberOfStates + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	frame = CubeRotation::IDENTITY;
+	movesPerSecond = 0.0;
+
+	turnKernel = CubeBitsliceKernels::TurnScalar;
+#if defined(SIMD_X86)
+	if (instructionSet == MoveEngine::SSSE3) {
+		turnKernel = CubeBitsliceKernels::TurnSse2;
+	}
+	else if (instructionSet == MoveEngine::AVX2) {
+		turnKernel = CubeBitsliceKernels::TurnAvx2;
+	}
+#endif
+
+	numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+	if (numberOfThreads < 1) {
+		numberOfThreads = 1;
+	}
+
+	// Every cube starts solved, including the unused ones at the end of the last block
+	planes.assign(numberOfBlocks * BLOCK_WORDS, 0);
+	for (size_t block = 0; block < numberOfBlocks; block++) {
+		for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+			for (int plane = 0; plane < PLANES_PER_SLOT; plane++) {
+				uint64_t word = (CubeState::SOLVED_BYTES[GetStateIndex(slot)] >> GetPlaneBit(slot, plane)) & 1 ? ~0ULL : 0ULL;
+				for (int i = 0; i < WORDS_PER_PLANE; i++) {
+					planes[block * BLOCK_WORDS + (slot * PLANES_PER_SLOT + plane) * WORDS_PER_PLANE + i] = word;
+				}
+			}
+		}
+	}
+
+	for (int move = 0; move < CubeMoves::NUMBER_OF_MOVES; move++) {
+		moveAlgorithms.push_back(CubeAlgorithm(std::vector<uint8_t>(1, static_cast<uint8_t>(move))));
+	}
+}
+
+void CubeBitslice::Apply(int move)
+{
+	Apply(moveAlgorithms[move]);
+}
+
+void CubeBitslice::Apply(const uint8_t* moves, size_t numberOfMoves)
+{
+	// The cubes share their frame, so the whole sequence can be resolved into slot turns before touching them
+	std::vector<SlotTurn> turns(numberOfMoves);
+	for (size_t i = 0; i < numberOfMoves; i++) {
+		const CubeAlgorithm& algorithm = moveAlgorithms[moves[i]];
+		turns[i] = GetSlotTurn(algorithm.GetPermutations()[frame]);
+		frame = algorithm.GetFinalFrames()[frame];
+	}
+
+	Apply(turns);
+}
+
+void CubeBitslice::Apply(const CubeAlgorithm& algorithm)
+{
+	std::vector<SlotTurn> turns(1, GetSlotTurn(algorithm.GetPermutations()[frame]));
+	frame = algorithm.GetFinalFrames()[frame];
+
+	Apply(turns);
+}
+
+void CubeBitslice::Apply(const std::vector<SlotTurn>& turns)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Give each thread a contiguous run of blocks, and keep one for the calling thread
+	size_t numberOfWorkers = numberOfThreads < 1 ? 1 : static_cast<size_t>(numberOfThreads);
+	if (numberOfWorkers > numberOfBlocks) {
+		numberOfWorkers = numberOfBlocks > 0 ? numberOfBlocks : 1;
+	}
+
+	std::vector<std::thread> workers;
+	size_t firstBlock = 0;
+	for (size_t i = 0; i < numberOfWorkers; i++) {
+		size_t endBlock = numberOfBlocks * (i + 1) / numberOfWorkers;
+
+		if (i + 1 < numberOfWorkers) {
+			workers.push_back(std::thread(&CubeBitslice::ApplyBlocks, this, std::cref(turns), firstBlock, endBlock));
+		}
+		else {
+			ApplyBlocks(turns, firstBlock, endBlock);
+		}
+
+		firstBlock = endBlock;
+	}
+
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	movesPerSecond = seconds > 0.0 ? static_cast<double>(numberOfStates) * turns.size() / seconds : 0.0;
+}
+
+void CubeBitslice::ApplyBlocks(const std::vector<SlotTurn>& turns, size_t firstBlock, size_t endBlock)
+{
+	if (turns.empty()) {
+		return;
+	}
+
+	alignas(32) uint64_t buffers[2][BLOCK_WORDS];
+
+	for (size_t block = firstBlock; block < endBlock; block++) {
+		// Turn the block back and forth between two buffers, and only write the last one back
+		uint64_t* blockPlanes = planes.data() + block * BLOCK_WORDS;
+		const uint64_t* source = blockPlanes;
+		for (size_t i = 0; i < turns.size(); i++) {
+			uint64_t* destination = buffers[i & 1];
+			turnKernel(turns[i], source, destination);
+			source = destination;
+		}
+
+		memcpy(blockPlanes, source, sizeof(buffers[0]));
+	}
+}
+
+void CubeBitslice::SetState(size_t index, const CubeState& state)
+{
+	uint64_t* blockPlanes = planes.data() + index / BLOCK_SIZE * BLOCK_WORDS;
+	size_t lane = index % BLOCK_SIZE;
+	uint64_t bit = 1ULL << (lane % 64);
+
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		uint8_t value = state.bytes[GetStateIndex(slot)];
+		for (int plane = 0; plane < PLANES_PER_SLOT; plane++) {
+			uint64_t& word = blockPlanes[(slot * PLANES_PER_SLOT + plane) * WORDS_PER_PLANE + lane / 64];
+			word = (value >> GetPlaneBit(slot, plane)) & 1 ? word | bit : word & ~bit;
+		}
+	}
+}
+
+CubeState CubeBitslice::GetState(size_t index) const
+{
+	const uint64_t* blockPlanes = planes.data() + index / BLOCK_SIZE * BLOCK_WORDS;
+	size_t lane = index % BLOCK_SIZE;
+
+	CubeState state;
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		int value = 0;
+		for (int plane = 0; plane < PLANES_PER_SLOT; plane++) {
+			uint64_t word = blockPlanes[(slot * PLANES_PER_SLOT + plane) * WORDS_PER_PLANE + lane / 64];
+			value |= static_cast<int>((word >> (lane % 64)) & 1) << GetPlaneBit(slot, plane);
+		}
+		state.bytes[GetStateIndex(slot)] = static_cast<uint8_t>(value);
+	}
+	state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+	state.UpdateInvariants();
+
+	return state;
+}
+
+size_t CubeBitslice::CountSolved() const
+{
+	// A cube is solved when every plane holds the bit of the solved cube, so 64 cubes are checked with each word
+	size_t count = 0;
+	for (size_t block = 0; block < numberOfBlocks; block++) {
+		const uint64_t* blockPlanes = planes.data() + block * BLOCK_WORDS;
+
+		for (int i = 0; i < WORDS_PER_PLANE; i++) {
+			uint64_t isSolved = ~0ULL;
+			for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+				for (int plane = 0; plane < PLANES_PER_SLOT; plane++) {
+					uint64_t word = blockPlanes[(slot * PLANES_PER_SLOT + plane) * WORDS_PER_PLANE + i];
+					isSolved &= (CubeState::SOLVED_BYTES[GetStateIndex(slot)] >> GetPlaneBit(slot, plane)) & 1 ? word : ~word;
+				}
+			}
+
+			// Leave out the unused cubes at the end of the last block
+			size_t firstState = block * BLOCK_SIZE + i * 64;
+			if (firstState >= numberOfStates) {
+				break;
+			}
+			if (numberOfStates - firstState < 64) {
+				isSolved &= (1ULL << (numberOfStates - firstState)) - 1;
+			}
+
+			count += CountBits(isSolved);
+		}
+	}
+
+	return count;
+}
+
+void CubeBitslice::SetNumberOfThreads(int numberOfThreads)
+{
+	this->numberOfThreads = numberOfThreads < 1 ? 1 : numberOfThreads;
+}
+
+CubeBitslice::SlotTurn CubeBitslice::GetSlotTurn(const MoveEngine::FacePairTurn& permutation)
+{
+	SlotTurn turn;
+	for (int slot = 0; slot < NUMBER_OF_SLOTS; slot++) {
+		int index = GetStateIndex(slot);
+		int sourceIndex = (index & 16) + permutation.shuffle[index];
+		int sourceSlot = sourceIndex < CubeState::CORNER_OFFSET ? sourceIndex - CubeState::EDGE_OFFSET : CubeState::NUMBER_OF_EDGES + sourceIndex - CubeState::CORNER_OFFSET;
+
+		turn.sourceSlots[slot] = static_cast<uint8_t>(sourceSlot);
+		turn.twists[slot] = static_cast<uint8_t>(permutation.twist[index] >> CubeState::ORIENTATION_SHIFT);
+	}
+
+	return turn;
+}
+
+int CubeBitslice::GetStateIndex(int slot)
+{
+	return slot < CubeState::NUMBER_OF_EDGES ? CubeState::EDGE_OFFSET + slot : CubeState::CORNER_OFFSET + slot - CubeState::NUMBER_OF_EDGES;
+}
+
+int CubeBitslice::GetPlaneBit(int slot, int plane)
+{
+	// Corners only use 3 bits for their piece, their twist bits come right after
+	return slot >= CubeState::NUMBER_OF_EDGES && plane >= 3 ? plane + 1 : plane;
+}
\ No newline at end of file
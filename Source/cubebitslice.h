@@ -0,0 +1,93 @@
+/*
+	The main purpose of this class is to push very large numbers of cubes through the same moves, for random walk statistics and
+	scramble verification jobs that run billions of moves. It has no OpenGL dependency, so it can run headless.
+
+	Cubes are bitsliced: every bit of the packed CubeState bytes is stored in its own plane, and each bit position of a plane word
+	belongs to a different cube. Cubes are grouped in blocks of 256, where each plane is four 64-bit words (one AVX2 register). A move
+	only changes which slot the planes of a slot come from, plus a couple of bitwise operations on the orientation planes of the slots
+	whose pieces turn. No data-dependent shuffle is involved, so one pass over a block turns all of its 256 cubes at once.
+
+	Each slot has 5 planes. For edges, planes 0 to 3 are the bits of the piece and plane 4 is its flip. For corners, planes 0 to 2 are
+	the bits of the piece and planes 3 and 4 the two bits of its twist (see CubeState).
+
+	Every cube of the set goes through the same moves, so they all share a single frame (see CubeState): SetState expects states in the
+	frame of the set, and GetState returns them in it.
+*/
+
+#pragma once
+
+#include "cubealgorithm.h"
+#include "cubestate.h"
+#include "moveengine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CubeBitslice {
+public:
+	static const int NUMBER_OF_SLOTS = CubeState::NUMBER_OF_EDGES + CubeState::NUMBER_OF_CORNERS;
+	static const int PLANES_PER_SLOT = 5;
+	static const int WORDS_PER_PLANE = 4;
+	static const int BLOCK_SIZE = WORDS_PER_PLANE * 64; // Cubes sharing the words of their planes
+	static const int BLOCK_WORDS = NUMBER_OF_SLOTS * PLANES_PER_SLOT * WORDS_PER_PLANE;
+
+	CubeBitslice(size_t numberOfStates); // Solved cubes in the identity frame, using the best instruction set supported by the CPU
+	CubeBitslice(size_t numberOfStates, MoveEngine::InstructionSet instructionSet);
+	virtual ~CubeBitslice();
+
+	void Apply(int move); // Applies a move of the standard notation (see CubeMoves) to every cube
+	void Apply(const uint8_t* moves, size_t numberOfMoves); // Applies a sequence of moves, each block staying in the cache throughout
+	void Apply(const CubeAlgorithm& algorithm);
+
+	void SetState(size_t index, const CubeState& state); // The frame of the state is ignored, it must be the frame of the set
+	CubeState GetState(size_t index) const;
+
+	size_t CountSolved() const;
+
+	// Setters
+	void SetFrame(int frame) { this->frame = frame; } // Rotates every cube of the set as a whole, which leaves the pieces where they are
+	void SetNumberOfThreads(int numberOfThreads);
+
+	// Getters
+	size_t GetNumberOfStates() const { return numberOfStates; }
+	int GetFrame() const { return frame; }
+	int GetNumberOfThreads() const { return numberOfThreads; }
+	MoveEngine::InstructionSet GetInstructionSet() const { return instructionSet; }
+
+	double GetMovesPerSecond() const { return movesPerSecond; } // Cube moves (cubes times moves) per second of the last Apply
+
+protected:
+	// Where each slot takes its planes from during one move, and how much its piece twists (0 to 2, or 0 to 1 for edges)
+	struct SlotTurn {
+		uint8_t sourceSlots[NUMBER_OF_SLOTS];
+		uint8_t twists[NUMBER_OF_SLOTS];
+	};
+
+	// Turns the cubes of a block, reading the planes from source and writing them to destination
+	typedef void (*TurnKernel)(const SlotTurn& turn, const uint64_t* source, uint64_t* destination);
+
+	size_t numberOfStates;
+	size_t numberOfBlocks;
+	int frame;
+	int numberOfThreads;
+
+	MoveEngine::InstructionSet instructionSet;
+	TurnKernel turnKernel;
+
+	std::vector<uint64_t> planes; // Block after block, each holding the planes of its slots one after the other
+
+	std::vector<CubeAlgorithm> moveAlgorithms; // Each move compiled as an algorithm
+
+	double movesPerSecond;
+
+	void Initialize(size_t numberOfStates, MoveEngine::InstructionSet instructionSet);
+	void Apply(const std::vector<SlotTurn>& turns); // Spreads the blocks over the threads
+	void ApplyBlocks(const std::vector<SlotTurn>& turns, size_t firstBlock, size_t endBlock); // Work done by one thread
+
+	static SlotTurn GetSlotTurn(const MoveEngine::FacePairTurn& permutation); // The same turn in the packed CubeState layout
+	static int GetStateIndex(int slot); // Byte of the packed CubeState layout holding a slot
+	static int GetPlaneBit(int slot, int plane); // Bit of the packed CubeState byte stored in a plane
+
+	friend struct CubeBitsliceKernels;
+};
\ No newline at end of file
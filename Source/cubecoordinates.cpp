@@ -0,0 +1,236 @@
+#include "cubecoordinates.h"
+#include "cubemoves.h"
+#include "cuberanking.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <cstdint>
+#include <vector>
+
+const int CubeCoordinates::SIZES[NUMBER_OF_COORDINATES] = { 2187, 2048, 40320, 495, 11880 };
+
+static const int NUMBER_OF_SLICE_EDGES = 4;
+static const int FIRST_SLICE_EDGE = CubeState::FR; // FR, FL, BL and BR are the last four edges
+
+static int Factorial(int n)
+{
+	int result = 1;
+	for (int i = 2; i <= n; i++) {
+		result *= i;
+	}
+
+	return result;
+}
+
+static int Binomial(int n, int k)
+{
+	if (k > n) {
+		return 0;
+	}
+
+	int result = 1;
+	for (int i = 1; i <= k; i++) {
+		result = result * (n - k + i) / i;
+	}
+
+	return result;
+}
+
+CubeCoordinates::CubeCoordinates()
+{
+	for (int i = 0; i < NUMBER_OF_COORDINATES; i++) {
+		CreateMoveTable(static_cast<Coordinate>(i));
+	}
+
+	CreateTransitions();
+}
+
+CubeCoordinates::~CubeCoordinates()
+{
+}
+
+void CubeCoordinates::CreateMoveTable(Coordinate coordinate)
+{
+	std::vector<uint16_t>& table = moveTables[coordinate];
+	table.resize(SIZES[coordinate] * CubeState::NUMBER_OF_FACE_TURNS);
+
+	for (int value = 0; value < SIZES[coordinate]; value++) {
+		CubeState state;
+		SetCoordinate(state, coordinate, value);
+
+		for (int faceTurn = 0; faceTurn < CubeState::NUMBER_OF_FACE_TURNS; faceTurn++) {
+			CubeState turnedState = state;
+			turnedState.ApplyFaceTurn(faceTurn);
+			table[value * CubeState::NUMBER_OF_FACE_TURNS + faceTurn] = static_cast<uint16_t>(GetCoordinate(turnedState, coordinate));
+		}
+	}
+}
+
+void CubeCoordinates::CreateTransitions()
+{
+	for (int frame = 0; frame < CubeRotation::NUMBER_OF_ROTATIONS; frame++) {
+		for (int move = 0; move < CubeMoves::NUMBER_OF_MOVES; move++) {
+			CubeFace face;
+			int faceQuarterTurns, oppositeFaceQuarterTurns;
+			int newFrame = CubeState::ResolveLayerTurns(CubeMoves::GetLayerTurns(move), frame, face, faceQuarterTurns, oppositeFaceQuarterTurns);
+
+			Transition& transition = transitions[frame][move];
+			transition.faceTurns[0] = static_cast<int8_t>(faceQuarterTurns != 0 ? face * 3 + faceQuarterTurns - 1 : -1);
+			transition.faceTurns[1] = static_cast<int8_t>(oppositeFaceQuarterTurns != 0 ? CubeRotation::GetOppositeFace(face) * 3 + oppositeFaceQuarterTurns - 1 : -1);
+			transition.frame = static_cast<uint8_t>(newFrame);
+		}
+	}
+}
+
+void CubeCoordinates::ApplyFaceTurn(Coordinates& coordinates, int faceTurn) const
+{
+	for (int i = 0; i < NUMBER_OF_COORDINATES; i++) {
+		coordinates.values[i] = moveTables[i][coordinates.values[i] * CubeState::NUMBER_OF_FACE_TURNS + faceTurn];
+	}
+}
+
+void CubeCoordinates::ApplyMove(Coordinates& coordinates, int move) const
+{
+	const Transition& transition = transitions[coordinates.frame][move];
+	for (int i = 0; i < 2; i++) {
+		if (transition.faceTurns[i] >= 0) {
+			ApplyFaceTurn(coordinates, transition.faceTurns[i]);
+		}
+	}
+
+	coordinates.frame = transition.frame;
+}
+
+const char* CubeCoordinates::GetName(Coordinate coordinate)
+{
+	static const char* const NAMES[NUMBER_OF_COORDINATES] = { "corner orientation", "edge orientation", "corner permutation", "UD slice", "sorted UD slice" };
+	return NAMES[coordinate];
+}
+
+CubeCoordinates::Coordinates CubeCoordinates::GetCoordinates(const CubeState& state)
+{
+	Coordinates coordinates;
+	for (int i = 0; i < NUMBER_OF_COORDINATES; i++) {
+		coordinates.values[i] = static_cast<uint16_t>(GetCoordinate(state, static_cast<Coordinate>(i)));
+	}
+	coordinates.frame = static_cast<uint8_t>(state.GetFrame());
+
+	return coordinates;
+}
+
+int CubeCoordinates::GetCoordinate(const CubeState& state, Coordinate coordinate)
+{
+	int value = 0;
+
+	if (coordinate == CORNER_ORIENTATION) {
+		// Base 3 digits of the first seven corners, the last one follows from the others
+		for (int i = 0; i < CubeState::NUMBER_OF_CORNERS - 1; i++) {
+			value = value * 3 + state.GetCornerOrientation(i);
+		}
+	}
+	else if (coordinate == EDGE_ORIENTATION) {
+		for (int i = 0; i < CubeState::NUMBER_OF_EDGES - 1; i++) {
+			value = value * 2 + state.GetEdgeOrientation(i);
+		}
+	}
+	else if (coordinate == CORNER_PERMUTATION) {
+		uint8_t corners[CubeState::NUMBER_OF_CORNERS];
+		for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+			corners[i] = static_cast<uint8_t>(state.GetCorner(i));
+		}
+
+		value = CubeRanking::RankPermutation(corners, CubeState::NUMBER_OF_CORNERS);
+	}
+	else {
+		// Rank of the combination of slots holding slice edges, with slots counted from the back so that the solved cube is 0
+		uint8_t sliceEdges[NUMBER_OF_SLICE_EDGES];
+		int numberOfSliceEdges = 0;
+		for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+			int slot = CubeState::NUMBER_OF_EDGES - 1 - i;
+			int edge = state.GetEdge(slot);
+
+			if (edge >= FIRST_SLICE_EDGE) {
+				numberOfSliceEdges++;
+				value += Binomial(i, numberOfSliceEdges);
+				sliceEdges[NUMBER_OF_SLICE_EDGES - numberOfSliceEdges] = static_cast<uint8_t>(edge - FIRST_SLICE_EDGE);
+			}
+		}
+
+		if (coordinate == UD_SLICE_SORTED) {
+			value = value * Factorial(NUMBER_OF_SLICE_EDGES) + CubeRanking::RankPermutation(sliceEdges, NUMBER_OF_SLICE_EDGES);
+		}
+	}
+
+	return value;
+}
+
+void CubeCoordinates::SetCoordinate(CubeState& state, Coordinate coordinate, int value)
+{
+	if (coordinate == CORNER_ORIENTATION) {
+		int sum = 0;
+		for (int i = CubeState::NUMBER_OF_CORNERS - 2; i >= 0; i--) {
+			int orientation = value % 3;
+			value /= 3;
+			sum += orientation;
+
+			uint8_t& corner = state.bytes[CubeState::CORNER_OFFSET + i];
+			corner = static_cast<uint8_t>((corner & CubeState::PIECE_MASK) | (orientation << CubeState::ORIENTATION_SHIFT));
+		}
+
+		uint8_t& lastCorner = state.bytes[CubeState::CORNER_OFFSET + CubeState::NUMBER_OF_CORNERS - 1];
+		lastCorner = static_cast<uint8_t>((lastCorner & CubeState::PIECE_MASK) | (((3 - sum % 3) % 3) << CubeState::ORIENTATION_SHIFT));
+	}
+	else if (coordinate == EDGE_ORIENTATION) {
+		int sum = 0;
+		for (int i = CubeState::NUMBER_OF_EDGES - 2; i >= 0; i--) {
+			int orientation = value % 2;
+			value /= 2;
+			sum += orientation;
+
+			uint8_t& edge = state.bytes[CubeState::EDGE_OFFSET + i];
+			edge = static_cast<uint8_t>((edge & CubeState::PIECE_MASK) | (orientation << CubeState::ORIENTATION_SHIFT));
+		}
+
+		uint8_t& lastEdge = state.bytes[CubeState::EDGE_OFFSET + CubeState::NUMBER_OF_EDGES - 1];
+		lastEdge = static_cast<uint8_t>((lastEdge & CubeState::PIECE_MASK) | ((sum % 2) << CubeState::ORIENTATION_SHIFT));
+	}
+	else if (coordinate == CORNER_PERMUTATION) {
+		uint8_t corners[CubeState::NUMBER_OF_CORNERS];
+		CubeRanking::UnrankPermutation(value, corners, CubeState::NUMBER_OF_CORNERS);
+
+		for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+			uint8_t& corner = state.bytes[CubeState::CORNER_OFFSET + i];
+			corner = static_cast<uint8_t>((corner & ~CubeState::PIECE_MASK) | corners[i]);
+		}
+	}
+	else {
+		uint8_t sliceEdges[NUMBER_OF_SLICE_EDGES] = { 0, 1, 2, 3 };
+		if (coordinate == UD_SLICE_SORTED) {
+			CubeRanking::UnrankPermutation(value % Factorial(NUMBER_OF_SLICE_EDGES), sliceEdges, NUMBER_OF_SLICE_EDGES);
+			value /= Factorial(NUMBER_OF_SLICE_EDGES);
+		}
+
+		// Find the slots (counted from the back) of the combination, largest first
+		bool isSliceSlot[CubeState::NUMBER_OF_EDGES] = {};
+		for (int k = NUMBER_OF_SLICE_EDGES; k >= 1; k--) {
+			int i = k - 1;
+			while (Binomial(i + 1, k) <= value) {
+				i++;
+			}
+
+			value -= Binomial(i, k);
+			isSliceSlot[CubeState::NUMBER_OF_EDGES - 1 - i] = true;
+		}
+
+		// Slice edges go to those slots in order, the other edges fill the remaining slots in order
+		int sliceEdge = 0, otherEdge = 0;
+		for (int slot = 0; slot < CubeState::NUMBER_OF_EDGES; slot++) {
+			int edge = isSliceSlot[slot] ? FIRST_SLICE_EDGE + sliceEdges[sliceEdge++] : otherEdge++;
+
+			uint8_t& edgeByte = state.bytes[CubeState::EDGE_OFFSET + slot];
+			edgeByte = static_cast<uint8_t>((edgeByte & ~CubeState::PIECE_MASK) | edge);
+		}
+	}
+
+	state.UpdateInvariants();
+}
\ No newline at end of file
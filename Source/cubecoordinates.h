@@ -0,0 +1,64 @@
+/*
+	The main purpose of this class is to describe a CubeState with a few small integers (coordinates) and to move them with table
+	lookups, which is what solvers and state space statistics work on. Each coordinate captures one aspect of the cube:
+		CORNER_ORIENTATION	twists of the corners (3^7 = 2187 values)
+		EDGE_ORIENTATION	flips of the edges (2^11 = 2048 values)
+		CORNER_PERMUTATION	positions of the corners (8! = 40320 values)
+		UD_SLICE			slots holding the four FR, FL, BL, BR edges, whatever their order (12 choose 4 = 495 values)
+		UD_SLICE_SORTED		slots and order of those four edges (495 * 4! = 11880 values)
+	Every coordinate is 0 on a solved cube.
+
+	Like CubeState, coordinates are taken relative to the centers. The move tables are built once per instance, indexed by coordinate
+	value and face turn (see CubeState::NUMBER_OF_FACE_TURNS). Other moves of the notation are resolved into face turns with the frame
+	carried along, exactly as CubeState does.
+*/
+
+#pragma once
+
+#include "cubemoves.h"
+#include "cubestate.h"
+
+#include <cstdint>
+#include <vector>
+
+class CubeCoordinates {
+public:
+	enum Coordinate { CORNER_ORIENTATION, EDGE_ORIENTATION, CORNER_PERMUTATION, UD_SLICE, UD_SLICE_SORTED, NUMBER_OF_COORDINATES };
+
+	struct Coordinates {
+		uint16_t values[NUMBER_OF_COORDINATES];
+		uint8_t frame; // See CubeState::GetFrame
+	};
+
+	CubeCoordinates(); // Builds the move tables (about 2 MB, built in tens of milliseconds)
+	virtual ~CubeCoordinates();
+
+	// Moves a single coordinate, or all of them
+	int ApplyFaceTurn(Coordinate coordinate, int value, int faceTurn) const { return moveTables[coordinate][value * CubeState::NUMBER_OF_FACE_TURNS + faceTurn]; }
+	void ApplyFaceTurn(Coordinates& coordinates, int faceTurn) const;
+	void ApplyMove(Coordinates& coordinates, int move) const; // Applies a move of the standard notation (see CubeMoves)
+
+	static int GetSize(Coordinate coordinate) { return SIZES[coordinate]; }
+	static const char* GetName(Coordinate coordinate);
+
+	// Conversions between a CubeState and its coordinates. SetCoordinate only changes the aspect of the cube covered by the coordinate,
+	// and puts the pieces it does not track back in their home slots where it has to move them.
+	static Coordinates GetCoordinates(const CubeState& state);
+	static int GetCoordinate(const CubeState& state, Coordinate coordinate);
+	static void SetCoordinate(CubeState& state, Coordinate coordinate, int value);
+
+protected:
+	// Any move is two opposite face turns plus a change of frame (see CubeState::ResolveLayerTurns)
+	struct Transition {
+		int8_t faceTurns[2]; // -1 when the face does not turn
+		uint8_t frame;
+	};
+
+	static const int SIZES[NUMBER_OF_COORDINATES];
+
+	std::vector<uint16_t> moveTables[NUMBER_OF_COORDINATES];
+	Transition transitions[CubeRotation::NUMBER_OF_ROTATIONS][CubeMoves::NUMBER_OF_MOVES];
+
+	void CreateMoveTable(Coordinate coordinate);
+	void CreateTransitions();
+};
\ No newline at end of file
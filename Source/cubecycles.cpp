@@ -0,0 +1,234 @@
+#include "cubecycles.h"
+#include "cubealgorithm.h"
+#include "cubebatch.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+#include "cubesymmetry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char* const CubeCycles::CORNER_NAMES[CubeState::NUMBER_OF_CORNERS] = { "URF", "UFL", "ULB", "UBR", "DFR", "DLF", "DBL", "DRB" };
+const char* const CubeCycles::EDGE_NAMES[CubeState::NUMBER_OF_EDGES] = { "UR", "UF", "UL", "UB", "DR", "DF", "DL", "DB", "FR", "FL", "BL", "BR" };
+
+static int GetGreatestCommonDivisor(int a, int b)
+{
+	while (b != 0) {
+		int remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+
+	return a;
+}
+
+CubeCycles::Decomposition CubeCycles::Decompose(const CubeState& state)
+{
+	Decomposition decomposition;
+	decomposition.numberOfCornerCycles = 0;
+	decomposition.numberOfEdgeCycles = 0;
+
+	for (int type = 0; type < 2; type++) {
+		bool isCorner = type == 0;
+		int offset = isCorner ? CubeState::CORNER_OFFSET : CubeState::EDGE_OFFSET;
+		int numberOfPieces = isCorner ? CubeState::NUMBER_OF_CORNERS : CubeState::NUMBER_OF_EDGES;
+		int modulus = isCorner ? 3 : 2;
+
+		// Slot holding each piece, which is where the piece of that home slot went
+		int destinations[CubeState::NUMBER_OF_EDGES];
+		for (int slot = 0; slot < numberOfPieces; slot++) {
+			destinations[state.bytes[offset + slot] & CubeState::PIECE_MASK] = slot;
+		}
+
+		bool isVisited[CubeState::NUMBER_OF_EDGES] = {};
+		for (int start = 0; start < numberOfPieces; start++) {
+			if (isVisited[start]) {
+				continue;
+			}
+
+			Cycle cycle;
+			cycle.length = 0;
+			cycle.twist = 0;
+
+			int slot = start;
+			do {
+				isVisited[slot] = true;
+				cycle.slots[cycle.length++] = static_cast<uint8_t>(slot);
+				cycle.twist += state.bytes[offset + slot] >> CubeState::ORIENTATION_SHIFT;
+				slot = destinations[slot];
+			} while (slot != start);
+			cycle.twist %= modulus;
+
+			if (cycle.length == 1 && cycle.twist == 0) {
+				continue;
+			}
+
+			if (isCorner) {
+				decomposition.cornerCycles[decomposition.numberOfCornerCycles++] = cycle;
+			}
+			else {
+				decomposition.edgeCycles[decomposition.numberOfEdgeCycles++] = cycle;
+			}
+		}
+	}
+
+	return decomposition;
+}
+
+std::string CubeCycles::ToString(const Decomposition& decomposition)
+{
+	std::string result;
+
+	for (int type = 0; type < 2; type++) {
+		bool isCorner = type == 0;
+		int numberOfCycles = isCorner ? decomposition.numberOfCornerCycles : decomposition.numberOfEdgeCycles;
+
+		for (int i = 0; i < numberOfCycles; i++) {
+			const Cycle& cycle = isCorner ? decomposition.cornerCycles[i] : decomposition.edgeCycles[i];
+
+			if (!result.empty()) {
+				result += ' ';
+			}
+
+			result += '(';
+			for (int j = 0; j < cycle.length; j++) {
+				if (j > 0) {
+					result += ' ';
+				}
+				result += isCorner ? CORNER_NAMES[cycle.slots[j]] : EDGE_NAMES[cycle.slots[j]];
+			}
+			result += ')';
+
+			if (cycle.twist != 0) {
+				result += cycle.twist == 1 ? '+' : '-';
+			}
+		}
+	}
+
+	return result;
+}
+
+int CubeCycles::GetOrder(const CubeState& state)
+{
+	// From a cube in another frame, the same moves turn the pieces as the state conjugated by the inverse of that frame, and compose
+	// their rotation with it. Once the frame is back to the identity, the pieces repeat with their own order.
+	uint8_t product[CubeState::STATE_SIZE];
+	memcpy(product, state.bytes, CubeState::STATE_SIZE);
+
+	int repetitions = 1;
+	int frame = state.GetFrame();
+	while (frame != CubeRotation::IDENTITY) {
+		CubeState step = CubeSymmetry::Conjugate(state, CubeRotation::Inverse(frame));
+		Multiply(product, step.bytes, product);
+
+		frame = CubeRotation::Compose(state.GetFrame(), frame);
+		repetitions++;
+	}
+
+	return repetitions * GetPieceOrder(product);
+}
+
+int CubeCycles::GetOrder(const CubeAlgorithm& algorithm)
+{
+	// The compiled algorithm already knows its effect from every frame
+	CubeState state;
+	int repetitions = 0;
+	do {
+		algorithm.Apply(state);
+		repetitions++;
+	} while (state.GetFrame() != CubeRotation::IDENTITY);
+
+	return repetitions * GetPieceOrder(state.bytes);
+}
+
+void CubeCycles::GetOrders(const CubeBatch& batch, uint16_t* orders)
+{
+	// Give each thread a contiguous run of states, and keep one for the calling thread
+	size_t numberOfStates = batch.GetNumberOfStates();
+	size_t numberOfWorkers = batch.GetNumberOfThreads() < 1 ? 1 : static_cast<size_t>(batch.GetNumberOfThreads());
+	if (numberOfWorkers > numberOfStates / CubeBatch::BLOCK_SIZE) {
+		numberOfWorkers = numberOfStates / CubeBatch::BLOCK_SIZE > 0 ? numberOfStates / CubeBatch::BLOCK_SIZE : 1;
+	}
+
+	std::vector<std::thread> workers;
+	size_t firstState = 0;
+	for (size_t i = 0; i < numberOfWorkers; i++) {
+		size_t endState = numberOfStates * (i + 1) / numberOfWorkers;
+
+		if (i + 1 < numberOfWorkers) {
+			workers.push_back(std::thread(&CubeCycles::ComputeOrders, std::cref(batch), firstState, endState, orders));
+		}
+		else {
+			ComputeOrders(batch, firstState, endState, orders);
+		}
+
+		firstState = endState;
+	}
+
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+void CubeCycles::ComputeOrders(const CubeBatch& batch, size_t firstState, size_t endState, uint16_t* orders)
+{
+	for (size_t i = firstState; i < endState; i++) {
+		orders[i] = static_cast<uint16_t>(GetOrder(batch.GetState(i)));
+	}
+}
+
+int CubeCycles::GetPieceOrder(const uint8_t* bytes)
+{
+	int order = 1;
+
+	for (int type = 0; type < 2; type++) {
+		bool isCorner = type == 0;
+		int offset = isCorner ? CubeState::CORNER_OFFSET : CubeState::EDGE_OFFSET;
+		int numberOfPieces = isCorner ? CubeState::NUMBER_OF_CORNERS : CubeState::NUMBER_OF_EDGES;
+		int modulus = isCorner ? 3 : 2;
+
+		// Walking from each slot to the slot its piece came from goes around the cycle backwards, which gives the same length and twist
+		bool isVisited[CubeState::NUMBER_OF_EDGES] = {};
+		for (int start = 0; start < numberOfPieces; start++) {
+			if (isVisited[start]) {
+				continue;
+			}
+
+			int length = 0;
+			int twist = 0;
+			int slot = start;
+			do {
+				isVisited[slot] = true;
+				twist += bytes[offset + slot] >> CubeState::ORIENTATION_SHIFT;
+				slot = bytes[offset + slot] & CubeState::PIECE_MASK;
+				length++;
+			} while (slot != start);
+
+			int cycleOrder = twist % modulus == 0 ? length : length * modulus;
+			order = order / GetGreatestCommonDivisor(order, cycleOrder) * cycleOrder;
+		}
+	}
+
+	return order;
+}
+
+void CubeCycles::Multiply(const uint8_t* first, const uint8_t* second, uint8_t* product)
+{
+	uint8_t result[CubeState::STATE_SIZE];
+	memcpy(result, first, CubeState::STATE_SIZE);
+
+	for (int i = CubeState::EDGE_OFFSET; i < CubeState::EDGE_OFFSET + CubeState::NUMBER_OF_EDGES; i++) {
+		result[i] = static_cast<uint8_t>(first[CubeState::EDGE_OFFSET + (second[i] & CubeState::PIECE_MASK)] + (second[i] & ~CubeState::PIECE_MASK));
+	}
+	for (int i = CubeState::CORNER_OFFSET; i < CubeState::CORNER_OFFSET + CubeState::NUMBER_OF_CORNERS; i++) {
+		result[i] = static_cast<uint8_t>(first[CubeState::CORNER_OFFSET + (second[i] & CubeState::PIECE_MASK)] + (second[i] & ~CubeState::PIECE_MASK));
+	}
+
+	CubeState::ReduceOrientations(result);
+	memcpy(product, result, CubeState::STATE_SIZE);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+	The main purpose of this class is to analyze a configuration as an element of the cube group: the cycles its corners and edges go
+	around, with the orientation they pick up on the way, and its order (how many times the moves leading to it must be repeated to get
+	back to where they started). Everything is computed from the permutation itself in a few dozen operations, without replaying moves.
+
+	A cycle of length n whose pieces come back twisted (or flipped) only closes after 3n (or 2n) repetitions, and the order is the least
+	common multiple of those lengths. Moves are seen from the world (see CubeState), so when they also rotate the whole cube, the next
+	repetition turns the pieces differently: the order then counts the repetitions that bring the frame back to the identity, times the
+	order of the pieces after them.
+*/
+
+#pragma once
+
+#include "cubealgorithm.h"
+#include "cubebatch.h"
+#include "cubestate.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class CubeCycles {
+public:
+	struct Cycle {
+		int length;
+		int twist; // Orientation (see CubeState) that a piece picks up going once around the cycle, 0 to 2 for corners and 0 to 1 for edges
+		uint8_t slots[CubeState::NUMBER_OF_EDGES]; // Each slot sends its piece to the next one, and the last one to the first
+	};
+
+	// Pieces left home with their orientation are not listed, and a piece twisted or flipped in place is a cycle of length 1
+	struct Decomposition {
+		int numberOfCornerCycles;
+		int numberOfEdgeCycles;
+		Cycle cornerCycles[CubeState::NUMBER_OF_CORNERS];
+		Cycle edgeCycles[CubeState::NUMBER_OF_EDGES];
+	};
+
+	static Decomposition Decompose(const CubeState& state); // Cycles of the pieces relative to the centers
+	static std::string ToString(const Decomposition& decomposition); // e.g. "(URF UBR DRB)+ (UF UR)", with + or - for a twist of 1 or 2 and + for a flip
+
+	static int GetOrder(const CubeState& state); // Order of the moves leading to the state from a solved cube in the identity frame
+	static int GetOrder(const CubeAlgorithm& algorithm);
+	static void GetOrders(const CubeBatch& batch, uint16_t* orders); // Order of every state of the batch, spread over its threads
+
+private:
+	static const char* const CORNER_NAMES[CubeState::NUMBER_OF_CORNERS];
+	static const char* const EDGE_NAMES[CubeState::NUMBER_OF_EDGES];
+
+	static int GetPieceOrder(const uint8_t* bytes); // Order of the pieces of a packed state, as if it were in the identity frame
+	static void Multiply(const uint8_t* first, const uint8_t* second, uint8_t* product); // The pieces of second applied after first, as in CubeAlgorithm::Apply
+	static void ComputeOrders(const CubeBatch& batch, size_t firstState, size_t endState, uint16_t* orders); // Work done by one thread
+};
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "cubefacelets.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+const char CubeFacelets::FACE_NAMES[NUMBER_OF_FACES + 1] = "URFDLB";
+
+const uint8_t CubeFacelets::CORNER_FACELETS[CubeState::NUMBER_OF_CORNERS][3] = {
+	{  8,  9, 20 }, // URF
+	{  6, 18, 38 }, // UFL
+	{  0, 36, 47 }, // ULB
+	{  2, 45, 11 }, // UBR
+	{ 29, 26, 15 }, // DFR
+	{ 27, 44, 24 }, // DLF
+	{ 33, 53, 42 }, // DBL
+	{ 35, 17, 51 }  // DRB
+};
+
+const uint8_t CubeFacelets::EDGE_FACELETS[CubeState::NUMBER_OF_EDGES][2] = {
+	{  5, 10 }, // UR
+	{  7, 19 }, // UF
+	{  3, 37 }, // UL
+	{  1, 46 }, // UB
+	{ 32, 16 }, // DR
+	{ 28, 25 }, // DF
+	{ 30, 43 }, // DL
+	{ 34, 52 }, // DB
+	{ 23, 12 }, // FR
+	{ 21, 41 }, // FL
+	{ 50, 39 }, // BL
+	{ 48, 14 }  // BR
+};
+
+// Lookup tables derived from the facelet layout, built on first use
+struct FaceletTables {
+	int8_t faceOfCharacter[256]; // -1 for characters that do not name a face
+	int8_t corners[NUMBER_OF_FACES * NUMBER_OF_FACES * NUMBER_OF_FACES]; // Corner with the given colors in clockwise order from its U or D color, or -1
+	int8_t edges[NUMBER_OF_FACES * NUMBER_OF_FACES]; // Edge with the given colors, with its flip in the orientation bits, or -1
+	int8_t centerFrames[NUMBER_OF_FACES][NUMBER_OF_FACES]; // Frame that puts the U and F centers on the given faces
+	uint8_t worldFacelets[CubeRotation::NUMBER_OF_ROTATIONS][CubeFacelets::NUMBER_OF_FACELETS]; // Where each facelet of the cube ends up in each frame
+
+	FaceletTables(const uint8_t cornerFacelets[][3], const uint8_t edgeFacelets[][2], const char* faceNames)
+	{
+		memset(faceOfCharacter, -1, sizeof(faceOfCharacter));
+		memset(corners, -1, sizeof(corners));
+		memset(edges, -1, sizeof(edges));
+		memset(centerFrames, -1, sizeof(centerFrames));
+
+		for (int face = 0; face < NUMBER_OF_FACES; face++) {
+			faceOfCharacter[static_cast<uint8_t>(faceNames[face])] = static_cast<int8_t>(face);
+		}
+
+		for (int corner = 0; corner < CubeState::NUMBER_OF_CORNERS; corner++) {
+			int colors[3];
+			for (int i = 0; i < 3; i++) {
+				colors[i] = cornerFacelets[corner][i] / CubeFacelets::FACELETS_PER_FACE;
+			}
+			corners[(colors[0] * NUMBER_OF_FACES + colors[1]) * NUMBER_OF_FACES + colors[2]] = static_cast<int8_t>(corner);
+		}
+
+		for (int edge = 0; edge < CubeState::NUMBER_OF_EDGES; edge++) {
+			int colors[2] = { edgeFacelets[edge][0] / CubeFacelets::FACELETS_PER_FACE, edgeFacelets[edge][1] / CubeFacelets::FACELETS_PER_FACE };
+			edges[colors[0] * NUMBER_OF_FACES + colors[1]] = static_cast<int8_t>(edge);
+			edges[colors[1] * NUMBER_OF_FACES + colors[0]] = static_cast<int8_t>(edge | (1 << CubeState::ORIENTATION_SHIFT));
+		}
+
+		for (int rotation = 0; rotation < CubeRotation::NUMBER_OF_ROTATIONS; rotation++) {
+			centerFrames[CubeRotation::RotateFace(rotation, FACE_U)][CubeRotation::RotateFace(rotation, FACE_F)] = static_cast<int8_t>(rotation);
+
+			// Rotate the position of each facelet along with its face, and find the facelet that is there
+			const int8_t (*matrix)[3] = CubeRotation::GetMatrix(rotation);
+			for (int facelet = 0; facelet < CubeFacelets::NUMBER_OF_FACELETS; facelet++) {
+				int position[3], rotatedPosition[3];
+				CubeFacelets::GetFaceletPosition(facelet, position);
+				for (int i = 0; i < 3; i++) {
+					rotatedPosition[i] = matrix[i][0] * position[0] + matrix[i][1] * position[1] + matrix[i][2] * position[2];
+				}
+
+				CubeFace rotatedFace = CubeRotation::RotateFace(rotation, CubeFacelets::GetFaceletFace(facelet));
+				for (int i = 0; i < CubeFacelets::FACELETS_PER_FACE; i++) {
+					int candidate = rotatedFace * CubeFacelets::FACELETS_PER_FACE + i;
+					int candidatePosition[3];
+					CubeFacelets::GetFaceletPosition(candidate, candidatePosition);
+
+					if (memcmp(candidatePosition, rotatedPosition, sizeof(rotatedPosition)) == 0) {
+						worldFacelets[rotation][facelet] = static_cast<uint8_t>(candidate);
+					}
+				}
+			}
+		}
+	}
+};
+
+static const FaceletTables& GetFaceletTables(const uint8_t cornerFacelets[][3], const uint8_t edgeFacelets[][2], const char* faceNames)
+{
+	static const FaceletTables tables(cornerFacelets, edgeFacelets, faceNames);
+	return tables;
+}
+
+CubeFacelets::Error CubeFacelets::Parse(const char* facelets, CubeState& state)
+{
+	const FaceletTables& tables = GetFaceletTables(CORNER_FACELETS, EDGE_FACELETS, FACE_NAMES);
+
+	uint8_t colors[NUMBER_OF_FACELETS];
+	int colorCounts[NUMBER_OF_FACES] = {};
+	for (int i = 0; i < NUMBER_OF_FACELETS; i++) {
+		int color = tables.faceOfCharacter[static_cast<uint8_t>(facelets[i])];
+		if (color < 0) {
+			return INVALID_CHARACTER;
+		}
+
+		colors[i] = static_cast<uint8_t>(color);
+		colorCounts[color]++;
+	}
+
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		if (colorCounts[face] != FACELETS_PER_FACE) {
+			return INVALID_COLOR_COUNT;
+		}
+	}
+
+	// The centers give the frame, the U and F ones are enough to find it
+	int centerFaces[NUMBER_OF_FACES] = {};
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		centerFaces[colors[face * FACELETS_PER_FACE + FACELETS_PER_FACE / 2]] = face;
+	}
+
+	int frame = tables.centerFrames[centerFaces[FACE_U]][centerFaces[FACE_F]];
+	if (frame < 0) {
+		return INVALID_CENTERS;
+	}
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		if (CubeRotation::RotateFace(frame, static_cast<CubeFace>(colors[face * FACELETS_PER_FACE + FACELETS_PER_FACE / 2])) != face) {
+			return INVALID_CENTERS;
+		}
+	}
+
+	// Read the stickers relative to the centers from here on
+	uint8_t relativeColors[NUMBER_OF_FACELETS];
+	for (int i = 0; i < NUMBER_OF_FACELETS; i++) {
+		relativeColors[i] = colors[tables.worldFacelets[frame][i]];
+	}
+
+	CubeState result;
+	int usedPieces = 0;
+	int twistSum = 0;
+	for (int slot = 0; slot < CubeState::NUMBER_OF_CORNERS; slot++) {
+		const uint8_t* corner = CORNER_FACELETS[slot];
+
+		int twist = 0;
+		while (twist < 3 && relativeColors[corner[twist]] != FACE_U && relativeColors[corner[twist]] != FACE_D) {
+			twist++;
+		}
+		if (twist == 3) {
+			return INVALID_CORNER;
+		}
+
+		int piece = tables.corners[(relativeColors[corner[twist]] * NUMBER_OF_FACES + relativeColors[corner[(twist + 1) % 3]]) * NUMBER_OF_FACES + relativeColors[corner[(twist + 2) % 3]]];
+		if (piece < 0 || (usedPieces & (1 << piece)) != 0) {
+			return INVALID_CORNER;
+		}
+
+		usedPieces |= 1 << piece;
+		twistSum += twist;
+		result.bytes[CubeState::CORNER_OFFSET + slot] = static_cast<uint8_t>(piece | (twist << CubeState::ORIENTATION_SHIFT));
+	}
+
+	usedPieces = 0;
+	int flipSum = 0;
+	for (int slot = 0; slot < CubeState::NUMBER_OF_EDGES; slot++) {
+		int edge = tables.edges[relativeColors[EDGE_FACELETS[slot][0]] * NUMBER_OF_FACES + relativeColors[EDGE_FACELETS[slot][1]]];
+		if (edge < 0 || (usedPieces & (1 << (edge & CubeState::PIECE_MASK))) != 0) {
+			return INVALID_EDGE;
+		}
+
+		usedPieces |= 1 << (edge & CubeState::PIECE_MASK);
+		flipSum += edge >> CubeState::ORIENTATION_SHIFT;
+		result.bytes[CubeState::EDGE_OFFSET + slot] = static_cast<uint8_t>(edge);
+	}
+
+	if (twistSum % 3 != 0) {
+		return INVALID_CORNER_TWIST;
+	}
+	if (flipSum % 2 != 0) {
+		return INVALID_EDGE_FLIP;
+	}
+
+	// A face turn is a 4-cycle of corners and a 4-cycle of edges, so both permutations always have the same parity
+	int inversions = 0;
+	for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+		for (int j = i + 1; j < CubeState::NUMBER_OF_CORNERS; j++) {
+			inversions += result.GetCorner(j) < result.GetCorner(i);
+		}
+	}
+	for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+		for (int j = i + 1; j < CubeState::NUMBER_OF_EDGES; j++) {
+			inversions += result.GetEdge(j) < result.GetEdge(i);
+		}
+	}
+	if (inversions % 2 != 0) {
+		return INVALID_PARITY;
+	}
+
+	result.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+	state = result;
+	return FACELETS_VALID;
+}
+
+CubeFacelets::Error CubeFacelets::Parse(const std::string& facelets, CubeState& state)
+{
+	if (facelets.size() != NUMBER_OF_FACELETS) {
+		return INVALID_LENGTH;
+	}
+
+	return Parse(facelets.data(), state);
+}
+
+void CubeFacelets::Format(const CubeState& state, char* facelets)
+{
+	const FaceletTables& tables = GetFaceletTables(CORNER_FACELETS, EDGE_FACELETS, FACE_NAMES);
+
+	uint8_t relativeColors[NUMBER_OF_FACELETS];
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		relativeColors[face * FACELETS_PER_FACE + FACELETS_PER_FACE / 2] = static_cast<uint8_t>(face);
+	}
+
+	for (int slot = 0; slot < CubeState::NUMBER_OF_CORNERS; slot++) {
+		int piece = state.GetCorner(slot);
+		int twist = state.GetCornerOrientation(slot);
+		for (int i = 0; i < 3; i++) {
+			relativeColors[CORNER_FACELETS[slot][(i + twist) % 3]] = static_cast<uint8_t>(CORNER_FACELETS[piece][i] / FACELETS_PER_FACE);
+		}
+	}
+
+	for (int slot = 0; slot < CubeState::NUMBER_OF_EDGES; slot++) {
+		int piece = state.GetEdge(slot);
+		int flip = state.GetEdgeOrientation(slot);
+		for (int i = 0; i < 2; i++) {
+			relativeColors[EDGE_FACELETS[slot][(i + flip) % 2]] = static_cast<uint8_t>(EDGE_FACELETS[piece][i] / FACELETS_PER_FACE);
+		}
+	}
+
+	const uint8_t* worldFacelets = tables.worldFacelets[state.GetFrame()];
+	for (int i = 0; i < NUMBER_OF_FACELETS; i++) {
+		facelets[worldFacelets[i]] = FACE_NAMES[relativeColors[i]];
+	}
+}
+
+std::string CubeFacelets::Format(const CubeState& state)
+{
+	char facelets[NUMBER_OF_FACELETS];
+	Format(state, facelets);
+	return std::string(facelets, NUMBER_OF_FACELETS);
+}
+
+const char* CubeFacelets::GetErrorMessage(Error error)
+{
+	switch (error) {
+	case FACELETS_VALID:
+		return "valid";
+	case INVALID_LENGTH:
+		return "facelet strings must have 54 characters";
+	case INVALID_CHARACTER:
+		return "facelets must be one of U, R, F, D, L, B";
+	case INVALID_COLOR_COUNT:
+		return "every color must appear 9 times";
+	case INVALID_CENTERS:
+		return "the centers are not placed as on a cube";
+	case INVALID_CORNER:
+		return "a corner is invalid or appears twice";
+	case INVALID_EDGE:
+		return "an edge is invalid or appears twice";
+	case INVALID_CORNER_TWIST:
+		return "a corner is twisted";
+	case INVALID_EDGE_FLIP:
+		return "an edge is flipped";
+	case INVALID_PARITY:
+		return "two pieces are swapped";
+	}
+
+	return "unknown error";
+}
+
+CubeFace CubeFacelets::GetFaceFromName(char name)
+{
+	int face = GetFaceletTables(CORNER_FACELETS, EDGE_FACELETS, FACE_NAMES).faceOfCharacter[static_cast<uint8_t>(name)];
+	return face < 0 ? NUMBER_OF_FACES : static_cast<CubeFace>(face);
+}
+
+void CubeFacelets::GetFaceletPosition(int facelet, int position[3])
+{
+	int row = (facelet % FACELETS_PER_FACE) / 3;
+	int column = facelet % 3;
+
+	// Each face is read with the layout of the unfolded net (see the class description)
+	switch (GetFaceletFace(facelet)) {
+	case FACE_U:
+		position[0] = column - 1; position[1] = 1; position[2] = row - 1;
+		break;
+	case FACE_R:
+		position[0] = 1; position[1] = 1 - row; position[2] = 1 - column;
+		break;
+	case FACE_F:
+		position[0] = column - 1; position[1] = 1 - row; position[2] = 1;
+		break;
+	case FACE_D:
+		position[0] = column - 1; position[1] = -1; position[2] = 1 - row;
+		break;
+	case FACE_L:
+		position[0] = -1; position[1] = 1 - row; position[2] = column - 1;
+		break;
+	default:
+		position[0] = 1 - column; position[1] = 1 - row; position[2] = -1;
+		break;
+	}
+}
\ No newline at end of file
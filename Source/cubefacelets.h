@@ -0,0 +1,59 @@
+/*
+	The main purpose of this class is to load and dump CubeStates in the standard 54 character facelet format: the stickers of the
+	U, R, F, D, L and B faces in that order, 9 per face read row by row, each one named after the face whose center has its color.
+	Faces are read as on the usual unfolded net: U with B at the top, D with F at the top, and the side faces with U at the top.
+
+	The string describes the cube as seen in the world, so a cube whose frame is not the identity has its centers away from home
+	(e.g. the U face of the string is all F after an x rotation). Parsing checks everything that makes a string a reachable cube:
+	sticker counts, centers, that every corner and edge exists exactly once, corner twist and edge flip sums, and permutation parity.
+	Conversions only use small lookup tables, so millions of strings can be converted per second.
+*/
+
+#pragma once
+
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <string>
+
+class CubeFacelets {
+public:
+	static const int NUMBER_OF_FACELETS = 54;
+	static const int FACELETS_PER_FACE = 9;
+
+	enum Error {
+		FACELETS_VALID,
+		INVALID_LENGTH,
+		INVALID_CHARACTER, // Not one of U, R, F, D, L, B
+		INVALID_COLOR_COUNT, // Some color does not appear exactly 9 times
+		INVALID_CENTERS, // The centers are not placed as on a real cube
+		INVALID_CORNER, // Some corner has impossible colors or appears twice
+		INVALID_EDGE, // Some edge has impossible colors or appears twice
+		INVALID_CORNER_TWIST, // The twists of the corners do not add up to a multiple of 3
+		INVALID_EDGE_FLIP, // The flips of the edges do not add up to a multiple of 2
+		INVALID_PARITY // The corner and edge permutations do not have the same parity
+	};
+
+	// facelets must hold NUMBER_OF_FACELETS characters (it does not need to be null terminated). state is only changed when the string is valid.
+	static Error Parse(const char* facelets, CubeState& state);
+	static Error Parse(const std::string& facelets, CubeState& state);
+
+	// Writes NUMBER_OF_FACELETS characters, without null terminator
+	static void Format(const CubeState& state, char* facelets);
+	static std::string Format(const CubeState& state);
+
+	static const char* GetErrorMessage(Error error);
+
+	// Position of the cubie carrying the facelet, in cubie units from the center of the cube (each coordinate is -1, 0 or 1)
+	static void GetFaceletPosition(int facelet, int position[3]);
+	static CubeFace GetFaceletFace(int facelet) { return static_cast<CubeFace>(facelet / FACELETS_PER_FACE); }
+	static void GetFaceNormal(CubeFace face, int normal[3]) { GetFaceletPosition(face * FACELETS_PER_FACE + FACELETS_PER_FACE / 2, normal); }
+
+	static char GetFaceName(CubeFace face) { return FACE_NAMES[face]; }
+	static CubeFace GetFaceFromName(char name); // NUMBER_OF_FACES if name is not a face name
+
+private:
+	static const char FACE_NAMES[NUMBER_OF_FACES + 1];
+	static const uint8_t CORNER_FACELETS[CubeState::NUMBER_OF_CORNERS][3]; // Facelets of each corner slot, starting with the U or D one, then clockwise
+	static const uint8_t EDGE_FACELETS[CubeState::NUMBER_OF_EDGES][2];
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "cubehistory.h"
+#include "cubemoves.h"
+#include "cubestate.h"
+#include "cubesurface.h"
+#include "persistentsurface.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <typename State>
+CubeHistory<State>::CubeHistory(const State& state, int snapshotInterval) : state(state)
+{
+	this->snapshotInterval = snapshotInterval;
+	Reset(state);
+}
+
+template <typename State>
+CubeHistory<State>::~CubeHistory()
+{
+}
+
+template <typename State>
+void CubeHistory<State>::Reset(const State& state)
+{
+	journal.clear();
+	snapshots.assign(1, state);
+
+	this->state = state;
+	position = 0;
+}
+
+template <typename State>
+bool CubeHistory<State>::Record(const SliceTurn& turn)
+{
+	if (turn.slice < 0 || turn.slice >= MAXIMUM_SLICES) {
+		return false;
+	}
+	if ((turn.quarterTurns & 3) == 0) {
+		return true;
+	}
+
+	journal.resize(position);
+	snapshots.erase(snapshots.begin() + (position / snapshotInterval + 1), snapshots.end());
+
+	journal.push_back(EncodeTurn(turn));
+	state.ApplySliceTurn(turn.axis, turn.slice, turn.quarterTurns);
+	position++;
+
+	if (position % snapshotInterval == 0) {
+		snapshots.push_back(state);
+	}
+
+	return true;
+}
+
+template <typename State>
+SliceTurn CubeHistory<State>::Undo()
+{
+	position--;
+	SliceTurn turn = DecodeTurn(journal[position]);
+	turn.quarterTurns = 4 - turn.quarterTurns;
+
+	state.ApplySliceTurn(turn.axis, turn.slice, turn.quarterTurns);
+	return turn;
+}
+
+template <typename State>
+SliceTurn CubeHistory<State>::Redo()
+{
+	SliceTurn turn = DecodeTurn(journal[position]);
+	position++;
+
+	state.ApplySliceTurn(turn.axis, turn.slice, turn.quarterTurns);
+	return turn;
+}
+
+template <typename State>
+const State& CubeHistory<State>::Seek(size_t position)
+{
+	state = GetState(position);
+	this->position = position;
+	return state;
+}
+
+template <typename State>
+State CubeHistory<State>::GetState(size_t position) const
+{
+	size_t snapshot = position / snapshotInterval;
+	State replayedState = snapshots[snapshot];
+	for (size_t i = snapshot * snapshotInterval; i < position; i++) {
+		SliceTurn turn = DecodeTurn(journal[i]);
+		replayedState.ApplySliceTurn(turn.axis, turn.slice, turn.quarterTurns);
+	}
+
+	return replayedState;
+}
+
+template <typename State>
+typename CubeHistory<State>::Entry CubeHistory<State>::EncodeTurn(const SliceTurn& turn)
+{
+	return static_cast<Entry>((static_cast<Entry>(turn.slice) << 4) | (turn.axis << 2) | (turn.quarterTurns & 3));
+}
+
+template <typename State>
+SliceTurn CubeHistory<State>::DecodeTurn(Entry code)
+{
+	SliceTurn turn;
+	turn.axis = static_cast<CubeAxis>((code >> 2) & 3);
+	turn.slice = static_cast<int>(code >> 4);
+	turn.quarterTurns = code & 3;
+	return turn;
+}
+
+template class CubeHistory<CubeState>;
+template class CubeHistory<CubeSurface>;
+template class CubeHistory<PersistentSurface>;
\ No newline at end of file
@@ -0,0 +1,75 @@
+/*
+	The main purpose of this class is to remember the slice turns of a session so that they can be undone, redone or jumped to. Turns are
+	kept in a journal of one entry each (slice, axis and number of quarter turns), and a copy of the whole state is kept every
+	snapshotInterval turns. Undo and redo only read one entry of the journal and hand back the turn to apply to the cube. GetState rebuilds
+	the state after any number of turns from the last snapshot before it, so reaching any point of a session of millions of turns replays
+	fewer than snapshotInterval turns.
+
+	State is any cube model with ApplySliceTurn(CubeAxis, int, int): CubeState (the 3x3x3), CubeSurface (NxNxN cubes, whose snapshots
+	take 6 * N * N bytes each, so they call for a longer interval) and PersistentSurface (whose snapshots share the tiles the turns in
+	between did not touch) are instantiated in cubehistory.cpp. Entries are one byte for CubeState, whose slices go up to 2, and 32 bits for
+	the surfaces, which leaves room for slices up to MAXIMUM_SLICES - 1 (over 268 million). Record refuses the turns of other slices.
+*/
+
+#pragma once
+
+#include "cubemoves.h"
+#include "cubestate.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Type of a journal entry, wide enough for the slices of the cube model
+template <typename State>
+struct CubeHistoryEntry {
+	typedef uint32_t Type;
+};
+
+template <>
+struct CubeHistoryEntry<CubeState> {
+	typedef uint8_t Type;
+};
+
+template <typename State>
+class CubeHistory {
+public:
+	typedef typename CubeHistoryEntry<State>::Type Entry;
+
+	static const int MAXIMUM_SLICES = 1 << (8 * sizeof(Entry) - 4); // The 4 low bits of an entry hold the axis and the quarter turns
+
+	CubeHistory(const State& state, int snapshotInterval);
+	virtual ~CubeHistory();
+
+	void Reset(const State& state); // Forgets every turn, the session starts again from state
+	// Appends a turn at the current position, after dropping the turns that could have been redone. Returns false, recording nothing, when
+	// the slice does not fit in a journal entry.
+	bool Record(const SliceTurn& turn);
+
+	bool CanUndo() const { return position > 0; }
+	bool CanRedo() const { return position < journal.size(); }
+	SliceTurn Undo(); // Steps back and returns the turn that takes the cube there (the inverse of the last turn)
+	SliceTurn Redo(); // Steps forward and returns the turn to apply again
+
+	const State& Seek(size_t position); // Jumps to the state after the first position turns (position must not exceed GetNumberOfTurns)
+	State GetState(size_t position) const;
+
+	// Getters
+	const State& GetCurrentState() const { return state; }
+	size_t GetPosition() const { return position; }
+	size_t GetNumberOfTurns() const { return journal.size(); }
+	SliceTurn GetTurn(size_t index) const { return DecodeTurn(journal[index]); }
+	int GetSnapshotInterval() const { return snapshotInterval; }
+
+protected:
+	int snapshotInterval;
+
+	std::vector<Entry> journal;
+	std::vector<State> snapshots; // State after 0, snapshotInterval, 2 * snapshotInterval... turns, as long as they can be redone
+
+	State state; // State at the current position
+	size_t position; // Number of turns done (the others can be redone)
+
+	static Entry EncodeTurn(const SliceTurn& turn);
+	static SliceTurn DecodeTurn(Entry code);
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "cubemoves.h"
+#include "cuberotation.h"
+
+const char* const CubeMoves::NAMES[NUMBER_OF_MOVES] = {
+	"U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'", "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'",
+	"Uw", "Uw2", "Uw'", "Rw", "Rw2", "Rw'", "Fw", "Fw2", "Fw'", "Dw", "Dw2", "Dw'", "Lw", "Lw2", "Lw'", "Bw", "Bw2", "Bw'",
+	"M", "M2", "M'", "E", "E2", "E'", "S", "S2", "S'",
+	"x", "x2", "x'", "y", "y2", "y'", "z", "z2", "z'"
+};
+
+// A clockwise face turn is a -90 degree turn around the outward normal of the face. M follows L, E follows D, S follows F,
+// and x, y, z follow R, U, F.
+const LayerTurns CubeMoves::FAMILY_LAYER_TURNS[NUMBER_OF_FAMILIES] = {
+	{ AXIS_Y, { 0, 0, -1 } }, // U
+	{ AXIS_X, { 0, 0, -1 } }, // R
+	{ AXIS_Z, { 0, 0, -1 } }, // F
+	{ AXIS_Y, { 1, 0, 0 } }, // D
+	{ AXIS_X, { 1, 0, 0 } }, // L
+	{ AXIS_Z, { 1, 0, 0 } }, // B
+	{ AXIS_Y, { 0, -1, -1 } }, // Uw
+	{ AXIS_X, { 0, -1, -1 } }, // Rw
+	{ AXIS_Z, { 0, -1, -1 } }, // Fw
+	{ AXIS_Y, { 1, 1, 0 } }, // Dw
+	{ AXIS_X, { 1, 1, 0 } }, // Lw
+	{ AXIS_Z, { 1, 1, 0 } }, // Bw
+	{ AXIS_X, { 0, 1, 0 } }, // M
+	{ AXIS_Y, { 0, 1, 0 } }, // E
+	{ AXIS_Z, { 0, -1, 0 } }, // S
+	{ AXIS_X, { -1, -1, -1 } }, // x
+	{ AXIS_Y, { -1, -1, -1 } }, // y
+	{ AXIS_Z, { -1, -1, -1 } } // z
+};
+
+const char* CubeMoves::GetName(int move)
+{
+	return NAMES[move];
+}
+
+LayerTurns CubeMoves::GetLayerTurns(int move)
+{
+	LayerTurns turns = FAMILY_LAYER_TURNS[GetFamily(move)];
+	int quarterTurns = GetQuarterTurns(move);
+
+	for (int i = 0; i < 3; i++) {
+		turns.layers[i] = static_cast<int8_t>((turns.layers[i] * quarterTurns) & 3);
+	}
+
+	return turns;
+}
+
+LayerTurns CubeMoves::GetFrameLayerTurns(const LayerTurns& turns, int frame)
+{
+	// Find which face of the cube sits on the positive side of the world axis. When it is on the negative side of its own axis, the
+	// layers are numbered the other way and turn the other way around it.
+	CubeFace face = CubeRotation::RotateFace(CubeRotation::Inverse(frame), CubeRotation::GetPositiveFace(turns.axis));
+	bool isPositive = CubeRotation::IsPositiveFace(face);
+
+	LayerTurns frameTurns;
+	frameTurns.axis = CubeRotation::GetFaceAxis(face);
+	for (int i = 0; i < 3; i++) {
+		frameTurns.layers[i] = static_cast<int8_t>((isPositive ? turns.layers[i] : -turns.layers[2 - i]) & 3);
+	}
+
+	return frameTurns;
+}
\ No newline at end of file
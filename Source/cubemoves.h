@@ -0,0 +1,52 @@
+/*
+	The moves of the standard 3x3x3 notation: face turns (U R F D L B), wide turns (Uw Rw Fw Dw Lw Bw), slice turns (M E S) and
+	whole cube rotations (x y z), each as a clockwise quarter turn, a half turn or a counterclockwise quarter turn.
+
+	Every one of them turns some of the three layers along a single world axis, which is how CubeState, MoveEngine and the Rubik
+	class all see a move.
+*/
+
+#pragma once
+
+#include "cuberotation.h"
+
+#include <cstdint>
+
+// Quarter turns of the three layers along an axis, counterclockwise around the positive direction of the axis.
+// layers[0] is the layer on the negative side of the axis (slice 0 of the Rubik class) and layers[2] the one on the positive side.
+struct LayerTurns {
+	CubeAxis axis;
+	int8_t layers[3];
+};
+
+// Quarter turns of a single slice of an NxNxN cube, counterclockwise around the positive direction of the axis (slice 0 is on the
+// negative side, as in CubeState::ApplySliceTurn and CubeSurface::ApplySliceTurn)
+struct SliceTurn {
+	CubeAxis axis;
+	int slice;
+	int quarterTurns;
+};
+
+class CubeMoves {
+public:
+	// Moves are indexed family * 3 + (quarter turns - 1), e.g. R2 is R * 3 + 1 and R' is R * 3 + 2
+	enum Family { U, R, F, D, L, B, UW, RW, FW, DW, LW, BW, M, E, S, X, Y, Z, NUMBER_OF_FAMILIES };
+
+	static const int NUMBER_OF_MOVES = NUMBER_OF_FAMILIES * 3;
+
+	static int GetMove(Family family, int quarterTurns) { return family * 3 + ((quarterTurns & 3) - 1); } // quarterTurns must not be a multiple of 4
+	static Family GetFamily(int move) { return static_cast<Family>(move / 3); }
+	static int GetQuarterTurns(int move) { return move % 3 + 1; }
+	static int Inverse(int move) { return move - move % 3 + (2 - move % 3); }
+
+	static const char* GetName(int move);
+	static LayerTurns GetLayerTurns(int move);
+
+	// The same layer turns along the own axes of a cube whose frame (see CubeState) is frame, so that turning those layers of the cube
+	// does what turns does to the layers seen in the world
+	static LayerTurns GetFrameLayerTurns(const LayerTurns& turns, int frame);
+
+private:
+	static const char* const NAMES[NUMBER_OF_MOVES];
+	static const LayerTurns FAMILY_LAYER_TURNS[NUMBER_OF_FAMILIES]; // Layer turns of the clockwise quarter turn of each family
+};
\ No newline at end of file
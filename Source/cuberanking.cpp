@@ -0,0 +1,350 @@
+#include "cuberanking.h"
+#include "cubebatch.h"
+#include "cubestate.h"
+#include "moveengine.h"
+#include "simd.h"
+
+#include <cstddef>
+#include <cstdint>
+
+struct CubeRankingKernels {
+	// Ranks of count states from their slot arrays, slots[i] being the array of slot i
+	static void RankCornersScalar(const uint8_t* const* slots, size_t begin, size_t end, uint32_t* ranks)
+	{
+		uint8_t corners[CubeState::NUMBER_OF_CORNERS];
+		for (size_t k = begin; k < end; k++) {
+			for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+				corners[i] = slots[i][k];
+			}
+			ranks[k] = CubeRanking::RankCorners(corners);
+		}
+	}
+
+	static void RankEdgesScalar(const uint8_t* const* slots, size_t begin, size_t end, uint64_t* ranks)
+	{
+		uint8_t edges[CubeState::NUMBER_OF_EDGES];
+		for (size_t k = begin; k < end; k++) {
+			for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+				edges[i] = slots[i][k];
+			}
+			ranks[k] = CubeRanking::RankEdges(edges);
+		}
+	}
+
+#if defined(SIMD_X86)
+	// Loads the slot of 8 states into 32 bit lanes, split into piece and orientation
+	TARGET_AVX2 static void LoadSlot(const uint8_t* slot, __m256i& piece, __m256i& orientation)
+	{
+		__m256i value = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(slot)));
+		piece = _mm256_and_si256(value, _mm256_set1_epi32(CubeState::PIECE_MASK));
+		orientation = _mm256_srli_epi32(value, CubeState::ORIENTATION_SHIFT);
+	}
+
+	// Lehmer code of n pieces in each lane: digit i counts the following pieces smaller than piece i, then the digits are
+	// combined with the same Horner scheme as CubeRanking::RankPermutation
+	TARGET_AVX2 static __m256i RankPermutations(const __m256i* pieces, int n)
+	{
+		__m256i rank = _mm256_setzero_si256();
+		for (int i = 0; i < n - 1; i++) {
+			__m256i digit = _mm256_setzero_si256();
+			for (int j = i + 1; j < n; j++) {
+				digit = _mm256_sub_epi32(digit, _mm256_cmpgt_epi32(pieces[i], pieces[j]));
+			}
+
+			rank = _mm256_add_epi32(_mm256_mullo_epi32(rank, _mm256_set1_epi32(n - i)), digit);
+		}
+
+		return rank;
+	}
+
+	TARGET_AVX2 static void RankCornersAvx2(const uint8_t* const* slots, size_t begin, size_t end, uint32_t* ranks)
+	{
+		size_t k = begin;
+		for (; k + 8 <= end; k += 8) {
+			__m256i pieces[CubeState::NUMBER_OF_CORNERS], orientations[CubeState::NUMBER_OF_CORNERS];
+			for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+				LoadSlot(slots[i] + k, pieces[i], orientations[i]);
+			}
+
+			__m256i orientation = _mm256_setzero_si256();
+			for (int i = 0; i < CubeState::NUMBER_OF_CORNERS - 1; i++) {
+				orientation = _mm256_add_epi32(_mm256_mullo_epi32(orientation, _mm256_set1_epi32(3)), orientations[i]);
+			}
+
+			__m256i rank = _mm256_mullo_epi32(RankPermutations(pieces, CubeState::NUMBER_OF_CORNERS), _mm256_set1_epi32(CubeRanking::CORNER_ORIENTATIONS));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(ranks + k), _mm256_add_epi32(rank, orientation));
+		}
+
+		RankCornersScalar(slots, k, end, ranks);
+	}
+
+	TARGET_AVX2 static void RankEdgesAvx2(const uint8_t* const* slots, size_t begin, size_t end, uint64_t* ranks)
+	{
+		size_t k = begin;
+		for (; k + 8 <= end; k += 8) {
+			__m256i pieces[CubeState::NUMBER_OF_EDGES], orientations[CubeState::NUMBER_OF_EDGES];
+			for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+				LoadSlot(slots[i] + k, pieces[i], orientations[i]);
+			}
+
+			__m256i orientation = _mm256_setzero_si256();
+			for (int i = 0; i < CubeState::NUMBER_OF_EDGES - 1; i++) {
+				orientation = _mm256_or_si256(_mm256_slli_epi32(orientation, 1), orientations[i]);
+			}
+
+			// The permutation rank needs 29 bits, so the full rank is assembled in 64 bit lanes
+			__m256i permutation = RankPermutations(pieces, CubeState::NUMBER_OF_EDGES);
+			__m256i low = _mm256_or_si256(_mm256_slli_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(permutation)), 11), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(orientation)));
+			__m256i high = _mm256_or_si256(_mm256_slli_epi64(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(permutation, 1)), 11), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(orientation, 1)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(ranks + k), low);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(ranks + k + 4), high);
+		}
+
+		RankEdgesScalar(slots, k, end, ranks);
+	}
+#endif
+};
+
+uint32_t CubeRanking::RankPermutation(const uint8_t* permutation, int n)
+{
+	// Each digit counts the smaller values not used yet, found with a bit set of the values seen so far
+	uint32_t rank = 0;
+	uint32_t seen = 0;
+	for (int i = 0; i < n; i++) {
+		uint32_t smaller = (1u << permutation[i]) - 1;
+		uint32_t digit = permutation[i];
+		for (uint32_t used = seen & smaller; used != 0; used &= used - 1) {
+			digit--;
+		}
+
+		rank = rank * (n - i) + digit;
+		seen |= 1u << permutation[i];
+	}
+
+	return rank;
+}
+
+void CubeRanking::UnrankPermutation(uint32_t rank, uint8_t* permutation, int n)
+{
+	// Digits of the Lehmer code, last one first
+	uint8_t digits[16];
+	for (int i = n - 1; i >= 0; i--) {
+		digits[i] = static_cast<uint8_t>(rank % (n - i));
+		rank /= n - i;
+	}
+
+	// Each digit picks among the values still available
+	uint32_t available = (1u << n) - 1;
+	for (int i = 0; i < n; i++) {
+		uint32_t candidates = available;
+		for (int skipped = 0; skipped < digits[i]; skipped++) {
+			candidates &= candidates - 1;
+		}
+
+		int value = 0;
+		while ((candidates & (1u << value)) == 0) {
+			value++;
+		}
+
+		available &= ~(1u << value);
+		permutation[i] = static_cast<uint8_t>(value);
+	}
+}
+
+int CubeRanking::GetPermutationParity(const uint8_t* permutation, int n)
+{
+	int inversions = 0;
+	for (int i = 0; i < n; i++) {
+		for (int j = i + 1; j < n; j++) {
+			inversions += permutation[j] < permutation[i];
+		}
+	}
+
+	return inversions & 1;
+}
+
+uint32_t CubeRanking::RankCorners(const uint8_t* corners)
+{
+	uint8_t permutation[CubeState::NUMBER_OF_CORNERS];
+	uint32_t orientation = 0;
+	for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+		permutation[i] = corners[i] & CubeState::PIECE_MASK;
+		if (i < CubeState::NUMBER_OF_CORNERS - 1) {
+			orientation = orientation * 3 + (corners[i] >> CubeState::ORIENTATION_SHIFT);
+		}
+	}
+
+	return CubeRanking::RankPermutation(permutation, CubeState::NUMBER_OF_CORNERS) * CORNER_ORIENTATIONS + orientation;
+}
+
+uint64_t CubeRanking::RankEdges(const uint8_t* edges)
+{
+	uint8_t permutation[CubeState::NUMBER_OF_EDGES];
+	uint32_t orientation = 0;
+	for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+		permutation[i] = edges[i] & CubeState::PIECE_MASK;
+		if (i < CubeState::NUMBER_OF_EDGES - 1) {
+			orientation = (orientation << 1) | (edges[i] >> CubeState::ORIENTATION_SHIFT);
+		}
+	}
+
+	return (static_cast<uint64_t>(CubeRanking::RankPermutation(permutation, CubeState::NUMBER_OF_EDGES)) << 11) | orientation;
+}
+
+void CubeRanking::UnrankCorners(uint32_t rank, uint8_t* corners)
+{
+	uint8_t permutation[CubeState::NUMBER_OF_CORNERS];
+	UnrankPermutation(rank / CORNER_ORIENTATIONS, permutation, CubeState::NUMBER_OF_CORNERS);
+
+	uint32_t orientation = rank % CORNER_ORIENTATIONS;
+	int twistSum = 0;
+	for (int i = CubeState::NUMBER_OF_CORNERS - 2; i >= 0; i--) {
+		int twist = orientation % 3;
+		orientation /= 3;
+		twistSum += twist;
+
+		corners[i] = static_cast<uint8_t>(permutation[i] | (twist << CubeState::ORIENTATION_SHIFT));
+	}
+
+	int lastTwist = (3 - twistSum % 3) % 3;
+	corners[CubeState::NUMBER_OF_CORNERS - 1] = static_cast<uint8_t>(permutation[CubeState::NUMBER_OF_CORNERS - 1] | (lastTwist << CubeState::ORIENTATION_SHIFT));
+}
+
+void CubeRanking::UnrankEdges(uint64_t rank, uint8_t* edges)
+{
+	uint8_t permutation[CubeState::NUMBER_OF_EDGES];
+	UnrankPermutation(static_cast<uint32_t>(rank >> 11), permutation, CubeState::NUMBER_OF_EDGES);
+
+	uint32_t orientation = static_cast<uint32_t>(rank & (EDGE_ORIENTATIONS - 1));
+	int flipSum = 0;
+	for (int i = 0; i < CubeState::NUMBER_OF_EDGES - 1; i++) {
+		int flip = (orientation >> (CubeState::NUMBER_OF_EDGES - 2 - i)) & 1;
+		flipSum += flip;
+		edges[i] = static_cast<uint8_t>(permutation[i] | (flip << CubeState::ORIENTATION_SHIFT));
+	}
+
+	edges[CubeState::NUMBER_OF_EDGES - 1] = static_cast<uint8_t>(permutation[CubeState::NUMBER_OF_EDGES - 1] | ((flipSum & 1) << CubeState::ORIENTATION_SHIFT));
+}
+
+uint32_t CubeRanking::RankCorners(const CubeState& state)
+{
+	return RankCorners(state.bytes + CubeState::CORNER_OFFSET);
+}
+
+uint64_t CubeRanking::RankEdges(const CubeState& state)
+{
+	return RankEdges(state.bytes + CubeState::EDGE_OFFSET);
+}
+
+CubeRanking::StateRank CubeRanking::Rank(const CubeState& state)
+{
+	// Permutation ranks 2k and 2k + 1 only differ by a swap of the last two pieces, so one of them is even and the other odd, and
+	// halving the edge permutation rank drops the parity
+	uint64_t edges = RankEdges(state);
+
+	StateRank rank;
+	rank.corners = RankCorners(state);
+	rank.edges = ((edges >> 12) << 11) | (edges & (EDGE_ORIENTATIONS - 1));
+	return rank;
+}
+
+void CubeRanking::UnrankCorners(uint32_t rank, CubeState& state)
+{
+	UnrankCorners(rank, state.bytes + CubeState::CORNER_OFFSET);
+	state.UpdateInvariants();
+}
+
+void CubeRanking::UnrankEdges(uint64_t rank, CubeState& state)
+{
+	UnrankEdges(rank, state.bytes + CubeState::EDGE_OFFSET);
+	state.UpdateInvariants();
+}
+
+void CubeRanking::Unrank(const StateRank& rank, CubeState& state)
+{
+	UnrankCorners(rank.corners, state);
+
+	uint8_t corners[CubeState::NUMBER_OF_CORNERS];
+	for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+		corners[i] = static_cast<uint8_t>(state.GetCorner(i));
+	}
+
+	// Try the even rank of the pair first, and switch to the odd one if the parity does not match the corners
+	uint64_t edges = ((rank.edges >> 11) << 12) | (rank.edges & (EDGE_ORIENTATIONS - 1));
+	UnrankEdges(edges, state);
+
+	uint8_t permutation[CubeState::NUMBER_OF_EDGES];
+	for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+		permutation[i] = static_cast<uint8_t>(state.GetEdge(i));
+	}
+
+	if (GetPermutationParity(permutation, CubeState::NUMBER_OF_EDGES) != GetPermutationParity(corners, CubeState::NUMBER_OF_CORNERS)) {
+		UnrankEdges(edges | (1ULL << 11), state);
+	}
+}
+
+void CubeRanking::RankCorners(const CubeBatch& batch, uint32_t* ranks)
+{
+	const uint8_t* slots[CubeState::NUMBER_OF_CORNERS];
+	for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+		slots[i] = batch.GetSlot(CubeState::NUMBER_OF_EDGES + i);
+	}
+
+#if defined(SIMD_X86)
+	if (batch.GetInstructionSet() == MoveEngine::AVX2) {
+		CubeRankingKernels::RankCornersAvx2(slots, 0, batch.GetNumberOfStates(), ranks);
+		return;
+	}
+#endif
+
+	CubeRankingKernels::RankCornersScalar(slots, 0, batch.GetNumberOfStates(), ranks);
+}
+
+void CubeRanking::RankEdges(const CubeBatch& batch, uint64_t* ranks)
+{
+	const uint8_t* slots[CubeState::NUMBER_OF_EDGES];
+	for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+		slots[i] = batch.GetSlot(i);
+	}
+
+#if defined(SIMD_X86)
+	if (batch.GetInstructionSet() == MoveEngine::AVX2) {
+		CubeRankingKernels::RankEdgesAvx2(slots, 0, batch.GetNumberOfStates(), ranks);
+		return;
+	}
+#endif
+
+	CubeRankingKernels::RankEdgesScalar(slots, 0, batch.GetNumberOfStates(), ranks);
+}
+
+void CubeRanking::UnrankCorners(const uint32_t* ranks, CubeBatch& batch)
+{
+	uint8_t* slots[CubeState::NUMBER_OF_CORNERS];
+	for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+		slots[i] = batch.GetSlot(CubeState::NUMBER_OF_EDGES + i);
+	}
+
+	uint8_t corners[CubeState::NUMBER_OF_CORNERS];
+	for (size_t k = 0; k < batch.GetNumberOfStates(); k++) {
+		UnrankCorners(ranks[k], corners);
+		for (int i = 0; i < CubeState::NUMBER_OF_CORNERS; i++) {
+			slots[i][k] = corners[i];
+		}
+	}
+}
+
+void CubeRanking::UnrankEdges(const uint64_t* ranks, CubeBatch& batch)
+{
+	uint8_t* slots[CubeState::NUMBER_OF_EDGES];
+	for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+		slots[i] = batch.GetSlot(i);
+	}
+
+	uint8_t edges[CubeState::NUMBER_OF_EDGES];
+	for (size_t k = 0; k < batch.GetNumberOfStates(); k++) {
+		UnrankEdges(ranks[k], edges);
+		for (int i = 0; i < CubeState::NUMBER_OF_EDGES; i++) {
+			slots[i][k] = edges[i];
+		}
+	}
+}
\ No newline at end of file
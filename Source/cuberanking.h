@@ -0,0 +1,67 @@
+/*
+	The main purpose of this class is to number cube states densely: every configuration of the corners gets a distinct rank in
+	[0, NUMBER_OF_CORNER_RANKS), every configuration of the edges one in [0, NUMBER_OF_EDGE_RANKS), and back. Dense ranks index
+	bit-packed tables and frontiers directly.
+
+	Permutations are ranked by their Lehmer code (rank 0 is the identity), orientations as base 3 (corners) or base 2 (edges) digits
+	of all pieces but the last, whose orientation follows from the others. A corner rank is permutation * 3^7 + orientation, an edge
+	rank permutation * 2^11 + orientation, which matches the CubeCoordinates conventions.
+
+	A whole cube has about 4.3 * 10^19 reachable states, which does not fit in 64 bits, so it is ranked as a pair (StateRank): the
+	corner rank, and the edge rank with the permutation parity left out (it always equals the corner parity). Ranks are relative to
+	the centers, the frame of a cube is not part of them.
+
+	The batch functions work on the structure of arrays of a CubeBatch, and rank 8 states per instruction with AVX2 when available.
+*/
+
+#pragma once
+
+#include "cubebatch.h"
+#include "cubestate.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class CubeRanking {
+public:
+	static const uint32_t NUMBER_OF_CORNER_RANKS = 88179840; // 8! * 3^7
+	static const uint64_t NUMBER_OF_EDGE_RANKS = 980995276800ULL; // 12! * 2^11
+	static const uint64_t NUMBER_OF_STATE_EDGE_RANKS = NUMBER_OF_EDGE_RANKS / 2; // Edge ranks of the states with a given corner configuration
+
+	// Dense over reachable cubes: corners * NUMBER_OF_STATE_EDGE_RANKS + edges enumerates all of them without gaps
+	struct StateRank {
+		uint32_t corners;
+		uint64_t edges;
+	};
+
+	// Permutations of 0..n-1, with n up to 12
+	static uint32_t RankPermutation(const uint8_t* permutation, int n);
+	static void UnrankPermutation(uint32_t rank, uint8_t* permutation, int n);
+	static int GetPermutationParity(const uint8_t* permutation, int n); // 0 for even permutations, 1 for odd ones
+
+	static uint32_t RankCorners(const CubeState& state);
+	static uint64_t RankEdges(const CubeState& state);
+	static StateRank Rank(const CubeState& state);
+
+	// These only change the pieces they rank, the frame and the other pieces are kept
+	static void UnrankCorners(uint32_t rank, CubeState& state);
+	static void UnrankEdges(uint64_t rank, CubeState& state);
+	static void Unrank(const StateRank& rank, CubeState& state);
+
+	// Batch versions: ranks must hold batch.GetNumberOfStates() values
+	static void RankCorners(const CubeBatch& batch, uint32_t* ranks);
+	static void RankEdges(const CubeBatch& batch, uint64_t* ranks);
+	static void UnrankCorners(const uint32_t* ranks, CubeBatch& batch);
+	static void UnrankEdges(const uint64_t* ranks, CubeBatch& batch);
+
+private:
+	static const uint32_t CORNER_ORIENTATIONS = 2187; // 3^7
+	static const uint32_t EDGE_ORIENTATIONS = 2048; // 2^11
+
+	static uint32_t RankCorners(const uint8_t* corners);
+	static uint64_t RankEdges(const uint8_t* edges);
+	static void UnrankCorners(uint32_t rank, uint8_t* corners);
+	static void UnrankEdges(uint64_t rank, uint8_t* edges);
+
+	friend struct CubeRankingKernels;
+};
\ No newline at end of file
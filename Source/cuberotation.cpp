@@ -0,0 +1,101 @@
+#include "cuberotation.h"
+
+#include <cstdint>
+
+// The tables below were generated by enumerating the 24 signed permutation matrices with determinant 1 and sorting them by the
+// index described in cuberotation.h.
+
+const int8_t CubeRotation::MATRICES[NUMBER_OF_ROTATIONS][3][3] = {
+	{ {  1,  0,  0 }, {  0,  1,  0 }, {  0,  0,  1 } },
+	{ {  0,  0,  1 }, {  0,  1,  0 }, { -1,  0,  0 } },
+	{ { -1,  0,  0 }, {  0,  1,  0 }, {  0,  0, -1 } },
+	{ {  0,  0, -1 }, {  0,  1,  0 }, {  1,  0,  0 } },
+	{ {  0,  1,  0 }, { -1,  0,  0 }, {  0,  0,  1 } },
+	{ {  0,  1,  0 }, {  0,  0,  1 }, {  1,  0,  0 } },
+	{ {  0,  1,  0 }, {  1,  0,  0 }, {  0,  0, -1 } },
+	{ {  0,  1,  0 }, {  0,  0, -1 }, { -1,  0,  0 } },
+	{ {  0,  0,  1 }, {  1,  0,  0 }, {  0,  1,  0 } },
+	{ { -1,  0,  0 }, {  0,  0,  1 }, {  0,  1,  0 } },
+	{ {  0,  0, -1 }, { -1,  0,  0 }, {  0,  1,  0 } },
+	{ {  1,  0,  0 }, {  0,  0, -1 }, {  0,  1,  0 } },
+	{ { -1,  0,  0 }, {  0, -1,  0 }, {  0,  0,  1 } },
+	{ {  0,  0,  1 }, {  0, -1,  0 }, {  1,  0,  0 } },
+	{ {  1,  0,  0 }, {  0, -1,  0 }, {  0,  0, -1 } },
+	{ {  0,  0, -1 }, {  0, -1,  0 }, { -1,  0,  0 } },
+	{ {  0, -1,  0 }, {  1,  0,  0 }, {  0,  0,  1 } },
+	{ {  0, -1,  0 }, {  0,  0,  1 }, { -1,  0,  0 } },
+	{ {  0, -1,  0 }, { -1,  0,  0 }, {  0,  0, -1 } },
+	{ {  0, -1,  0 }, {  0,  0, -1 }, {  1,  0,  0 } },
+	{ {  0,  0,  1 }, { -1,  0,  0 }, {  0, -1,  0 } },
+	{ {  1,  0,  0 }, {  0,  0,  1 }, {  0, -1,  0 } },
+	{ {  0,  0, -1 }, {  1,  0,  0 }, {  0, -1,  0 } },
+	{ { -1,  0,  0 }, {  0,  0, -1 }, {  0, -1,  0 } },
+};
+
+const uint8_t CubeRotation::COMPOSITION[NUMBER_OF_ROTATIONS][NUMBER_OF_ROTATIONS] = {
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23 },
+	{  1,  2,  3,  0, 20, 21, 22, 23,  6,  5,  4,  7, 13, 14, 15, 12,  8,  9, 10, 11, 18, 17, 16, 19 },
+	{  2,  3,  0,  1, 18, 17, 16, 19, 22, 21, 20, 23, 14, 15, 12, 13,  6,  5,  4,  7, 10,  9,  8, 11 },
+	{  3,  0,  1,  2, 10,  9,  8, 11, 16, 17, 18, 19, 15, 12, 13, 14, 22, 21, 20, 23,  4,  5,  6,  7 },
+	{  4,  7,  6,  5, 12, 13, 14, 15, 11,  8,  9, 10, 16, 19, 18, 17,  0,  1,  2,  3, 23, 20, 21, 22 },
+	{  5,  4,  7,  6,  9,  8, 11, 10,  0,  1,  2,  3, 17, 16, 19, 18, 21, 20, 23, 22, 12, 13, 14, 15 },
+	{  6,  5,  4,  7,  2,  1,  0,  3, 21, 20, 23, 22, 18, 17, 16, 19, 14, 13, 12, 15,  9,  8, 11, 10 },
+	{  7,  6,  5,  4, 23, 20, 21, 22, 14, 13, 12, 15, 19, 18, 17, 16, 11,  8,  9, 10,  2,  1,  0,  3 },
+	{  8,  9, 10, 11,  1,  0,  3,  2,  5,  4,  7,  6, 20, 21, 22, 23, 13, 12, 15, 14, 17, 16, 19, 18 },
+	{  9, 10, 11,  8, 17, 16, 19, 18,  3,  0,  1,  2, 21, 22, 23, 20,  5,  4,  7,  6, 15, 12, 13, 14 },
+	{ 10, 11,  8,  9, 15, 12, 13, 14, 19, 16, 17, 18, 22, 23, 20, 21,  3,  0,  1,  2,  7,  4,  5,  6 },
+	{ 11,  8,  9, 10,  7,  4,  5,  6, 13, 12, 15, 14, 23, 20, 21, 22, 19, 16, 17, 18,  1,  0,  3,  2 },
+	{ 12, 15, 14, 13, 16, 19, 18, 17, 10, 11,  8,  9,  0,  3,  2,  1,  4,  7,  6,  5, 22, 23, 20, 21 },
+	{ 13, 12, 15, 14,  8, 11, 10,  9,  4,  7,  6,  5,  1,  0,  3,  2, 20, 23, 22, 21, 16, 19, 18, 17 },
+	{ 14, 13, 12, 15,  6,  7,  4,  5, 20, 23, 22, 21,  2,  1,  0,  3, 18, 19, 16, 17,  8, 11, 10,  9 },
+	{ 15, 14, 13, 12, 22, 23, 20, 21, 18, 19, 16, 17,  3,  2,  1,  0, 10, 11,  8,  9,  6,  7,  4,  5 },
+	{ 16, 17, 18, 19,  0,  3,  2,  1,  9, 10, 11,  8,  4,  5,  6,  7, 12, 15, 14, 13, 21, 22, 23, 20 },
+	{ 17, 18, 19, 16, 21, 22, 23, 20,  2,  3,  0,  1,  5,  6,  7,  4,  9, 10, 11,  8, 14, 15, 12, 13 },
+	{ 18, 19, 16, 17, 14, 15, 12, 13, 23, 22, 21, 20,  6,  7,  4,  5,  2,  3,  0,  1, 11, 10,  9,  8 },
+	{ 19, 16, 17, 18, 11, 10,  9,  8, 12, 15, 14, 13,  7,  4,  5,  6, 23, 22, 21, 20,  0,  3,  2,  1 },
+	{ 20, 23, 22, 21, 13, 14, 15, 12,  7,  6,  5,  4,  8, 11, 10,  9,  1,  2,  3,  0, 19, 18, 17, 16 },
+	{ 21, 20, 23, 22,  5,  6,  7,  4,  1,  2,  3,  0,  9,  8, 11, 10, 17, 18, 19, 16, 13, 14, 15, 12 },
+	{ 22, 21, 20, 23,  3,  2,  1,  0, 17, 18, 19, 16, 10,  9,  8, 11, 15, 14, 13, 12,  5,  6,  7,  4 },
+	{ 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0 },
+};
+
+const uint8_t CubeRotation::INVERSE[NUMBER_OF_ROTATIONS] = {
+	0, 3, 2, 1, 16, 8, 6, 22, 5, 9, 17, 21, 12, 13, 14, 15, 4, 10, 18, 20, 19, 11, 7, 23
+};
+
+const uint8_t CubeRotation::FACE_MAP[NUMBER_OF_ROTATIONS][NUMBER_OF_FACES] = {
+	{ 0, 1, 2, 3, 4, 5 },
+	{ 0, 5, 1, 3, 2, 4 },
+	{ 0, 4, 5, 3, 1, 2 },
+	{ 0, 2, 4, 3, 5, 1 },
+	{ 1, 3, 2, 4, 0, 5 },
+	{ 1, 2, 0, 4, 5, 3 },
+	{ 1, 0, 5, 4, 3, 2 },
+	{ 1, 5, 3, 4, 2, 0 },
+	{ 2, 0, 1, 5, 3, 4 },
+	{ 2, 4, 0, 5, 1, 3 },
+	{ 2, 3, 4, 5, 0, 1 },
+	{ 2, 1, 3, 5, 4, 0 },
+	{ 3, 4, 2, 0, 1, 5 },
+	{ 3, 2, 1, 0, 5, 4 },
+	{ 3, 1, 5, 0, 4, 2 },
+	{ 3, 5, 4, 0, 2, 1 },
+	{ 4, 0, 2, 1, 3, 5 },
+	{ 4, 5, 0, 1, 2, 3 },
+	{ 4, 3, 5, 1, 0, 2 },
+	{ 4, 2, 3, 1, 5, 0 },
+	{ 5, 3, 1, 2, 0, 4 },
+	{ 5, 1, 0, 2, 4, 3 },
+	{ 5, 0, 4, 2, 3, 1 },
+	{ 5, 4, 3, 2, 1, 0 },
+};
+
+const uint8_t CubeRotation::AXIS_ROTATIONS[NUMBER_OF_AXES][4] = {
+	{  0, 11, 14, 21 },
+	{  0,  1,  2,  3 },
+	{  0, 16, 12,  4 },
+};
+
+const CubeAxis CubeRotation::FACE_AXES[NUMBER_OF_FACES] = { AXIS_Y, AXIS_X, AXIS_Z, AXIS_Y, AXIS_X, AXIS_Z };
+
+const CubeFace CubeRotation::POSITIVE_FACES[NUMBER_OF_AXES] = { FACE_R, FACE_U, FACE_F };
\ No newline at end of file
@@ -0,0 +1,49 @@
+/*
+	The 24 proper rotations of a cube, indexed by small integers that compose through lookup tables.
+	They describe whole-cube orientations (e.g. which world face each center of the Rubik's cube currently sits on) without any floating point.
+
+	Rotation r carries the U center to face r / 4. r % 4 tells where the F center goes: it is the index of that face among the four
+	faces perpendicular to face r / 4, taken in F, R, U, B, L, D order. Rotation 0 is the identity.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// Faces are named after their position on a cube held with U up and F facing the viewer (U = +Y, R = +X, F = +Z).
+// Opposite faces are always 3 apart.
+enum CubeFace { FACE_U, FACE_R, FACE_F, FACE_D, FACE_L, FACE_B, NUMBER_OF_FACES };
+enum CubeAxis { AXIS_X, AXIS_Y, AXIS_Z, NUMBER_OF_AXES };
+
+class CubeRotation {
+public:
+	static const int NUMBER_OF_ROTATIONS = 24;
+	static const int IDENTITY = 0;
+
+	// Rotation equal to applying inner first, then outer
+	static int Compose(int outer, int inner) { return COMPOSITION[outer][inner]; }
+	static int Inverse(int rotation) { return INVERSE[rotation]; }
+
+	// Face that the given face is carried to by the rotation
+	static CubeFace RotateFace(int rotation, CubeFace face) { return static_cast<CubeFace>(FACE_MAP[rotation][face]); }
+
+	// Rotation by quarterTurns * 90 degrees counterclockwise around the positive direction of axis
+	static int FromAxis(CubeAxis axis, int quarterTurns) { return AXIS_ROTATIONS[axis][quarterTurns & 3]; }
+
+	// Integer rotation matrix (row major), acting on column vectors
+	static const int8_t (*GetMatrix(int rotation))[3] { return MATRICES[rotation]; }
+
+	static CubeAxis GetFaceAxis(CubeFace face) { return FACE_AXES[face]; }
+	static CubeFace GetPositiveFace(CubeAxis axis) { return POSITIVE_FACES[axis]; } // Face on the positive side of the axis (R, U or F)
+	static bool IsPositiveFace(CubeFace face) { return face < FACE_D; }
+	static CubeFace GetOppositeFace(CubeFace face) { return static_cast<CubeFace>((face + 3) % NUMBER_OF_FACES); }
+
+private:
+	static const int8_t MATRICES[NUMBER_OF_ROTATIONS][3][3];
+	static const uint8_t COMPOSITION[NUMBER_OF_ROTATIONS][NUMBER_OF_ROTATIONS];
+	static const uint8_t INVERSE[NUMBER_OF_ROTATIONS];
+	static const uint8_t FACE_MAP[NUMBER_OF_ROTATIONS][NUMBER_OF_FACES];
+	static const uint8_t AXIS_ROTATIONS[NUMBER_OF_AXES][4];
+	static const CubeAxis FACE_AXES[NUMBER_OF_FACES];
+	static const CubeFace POSITIVE_FACES[NUMBER_OF_AXES];
+};
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "cubestate.h"
+#include "cuberotation.h"
+#include "cubesymmetry.h"
+
+#include <cstdint>
+#include <cstring>
+
+// Standard face turn definitions (corner twists and edge flips follow the usual U/D reference sticker convention)
+const uint8_t CubeState::FACE_TURN_SHUFFLES[NUMBER_OF_FACE_TURNS][STATE_SIZE] = {
+{  3,  0,  1,  2,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 19, 16, 17, 18, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // U
+	{  2,  3,  0,  1,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 18, 19, 16, 17, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // U2
+	{  1,  2,  3,  0,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 17, 18, 19, 16, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // U'
+	{  8,  1,  2,  3, 11,  5,  6,  7,  4,  9, 10,  0, 12, 13, 14, 15, 20, 17, 18, 16, 23, 21, 22, 19, 24, 25, 26, 27, 28, 29, 30, 31 }, // R
+	{  4,  1,  2,  3,  0,  5,  6,  7, 11,  9, 10,  8, 12, 13, 14, 15, 23, 17, 18, 20, 19, 21, 22, 16, 24, 25, 26, 27, 28, 29, 30, 31 }, // R2
+	{ 11,  1,  2,  3,  8,  5,  6,  7,  0,  9, 10,  4, 12, 13, 14, 15, 19, 17, 18, 23, 16, 21, 22, 20, 24, 25, 26, 27, 28, 29, 30, 31 }, // R'
+	{  0,  9,  2,  3,  4,  8,  6,  7,  1,  5, 10, 11, 12, 13, 14, 15, 17, 21, 18, 19, 16, 20, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // F
+	{  0,  5,  2,  3,  4,  1,  6,  7,  9,  8, 10, 11, 12, 13, 14, 15, 21, 20, 18, 19, 17, 16, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // F2
+	{  0,  8,  2,  3,  4,  9,  6,  7,  5,  1, 10, 11, 12, 13, 14, 15, 20, 16, 18, 19, 21, 17, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // F'
+	{  0,  1,  2,  3,  5,  6,  7,  4,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 21, 22, 23, 20, 24, 25, 26, 27, 28, 29, 30, 31 }, // D
+	{  0,  1,  2,  3,  6,  7,  4,  5,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 22, 23, 20, 21, 24, 25, 26, 27, 28, 29, 30, 31 }, // D2
+	{  0,  1,  2,  3,  7,  4,  5,  6,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 23, 20, 21, 22, 24, 25, 26, 27, 28, 29, 30, 31 }, // D'
+	{  0,  1, 10,  3,  4,  5,  9,  7,  8,  2,  6, 11, 12, 13, 14, 15, 16, 18, 22, 19, 20, 17, 21, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // L
+	{  0,  1,  6,  3,  4,  5,  2,  7,  8, 10,  9, 11, 12, 13, 14, 15, 16, 22, 21, 19, 20, 18, 17, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // L2
+	{  0,  1,  9,  3,  4,  5, 10,  7,  8,  6,  2, 11, 12, 13, 14, 15, 16, 21, 17, 19, 20, 22, 18, 23, 24, 25, 26, 27, 28, 29, 30, 31 }, // L'
+	{  0,  1,  2, 11,  4,  5,  6, 10,  8,  9,  3,  7, 12, 13, 14, 15, 16, 17, 19, 23, 20, 21, 18, 22, 24, 25, 26, 27, 28, 29, 30, 31 }, // B
+	{  0,  1,  2,  7,  4,  5,  6,  3,  8,  9, 11, 10, 12, 13, 14, 15, 16, 17, 23, 22, 20, 21, 19, 18, 24, 25, 26, 27, 28, 29, 30, 31 }, // B2
+	{  0,  1,  2, 10,  4,  5,  6, 11,  8,  9,  7,  3, 12, 13, 14, 15, 16, 17, 22, 18, 20, 21, 23, 19, 24, 25, 26, 27, 28, 29, 30, 31 }, // B'
+};
+
+const uint8_t CubeState::FACE_TURN_TWISTS[NUMBER_OF_FACE_TURNS][STATE_SIZE] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // U
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // U2
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // U'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // R
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // R2
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // R'
+	{ 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // F
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // F2
+	{ 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // F'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // D
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // D2
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // D'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // L
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // L2
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // L'
+	{ 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // B
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // B2
+	{ 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // B'
+};
+
+const uint8_t CubeState::SOLVED_BYTES[STATE_SIZE] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, CubeRotation::IDENTITY
+};
+
+CubeState::CubeState()
+{
+	memcpy(bytes, SOLVED_BYTES, STATE_SIZE);
+}
+
+void CubeState::ApplyFaceTurn(CubeFace face, int quarterTurns)
+{
+	quarterTurns &= 3;
+	if (quarterTurns == 0) {
+		return;
+	}
+
+	ApplyFaceTurn(face * 3 + quarterTurns - 1);
+}
+
+void CubeState::ApplyFaceTurn(int faceTurn)
+{
+	const uint8_t* shuffle = FACE_TURN_SHUFFLES[faceTurn];
+	const uint8_t* twist = FACE_TURN_TWISTS[faceTurn];
+
+	alignas(32) uint8_t result[STATE_SIZE];
+	for (int i = 0; i < STATE_SIZE; i++) {
+		result[i] = bytes[shuffle[i]] + twist[i];
+	}
+
+	ReduceOrientations(result);
+	memcpy(bytes, result, STATE_SIZE);
+}
+
+void CubeState::ReduceOrientations(uint8_t* bytes)
+{
+	for (int i = EDGE_OFFSET; i < EDGE_OFFSET + NUMBER_OF_EDGES; i++) {
+		bytes[i] &= 0x1F;
+	}
+	for (int i = CORNER_OFFSET; i < CORNER_OFFSET + NUMBER_OF_CORNERS; i++) {
+		if (bytes[i] >= (3 << ORIENTATION_SHIFT)) {
+			bytes[i] = static_cast<uint8_t>(bytes[i] - (3 << ORIENTATION_SHIFT));
+		}
+	}
+}
+
+void CubeState::ApplySliceTurn(CubeAxis axis, int slice, int quarterTurns)
+{
+	LayerTurns turns;
+	turns.axis = axis;
+	for (int i = 0; i < NUMBER_OF_SLICES; i++) {
+		turns.layers[i] = static_cast<int8_t>(i == slice ? quarterTurns : 0);
+	}
+
+	ApplyLayerTurns(turns);
+}
+
+void CubeState::ApplyLayerTurns(const LayerTurns& turns)
+{
+	CubeFace face;
+	int faceQuarterTurns, oppositeFaceQuarterTurns;
+	int frame = ResolveLayerTurns(turns, GetFrame(), face, faceQuarterTurns, oppositeFaceQuarterTurns);
+
+	ApplyFaceTurn(face, faceQuarterTurns);
+	ApplyFaceTurn(CubeRotation::GetOppositeFace(face), oppositeFaceQuarterTurns);
+	bytes[FRAME_OFFSET] = static_cast<uint8_t>(frame);
+}
+
+int CubeState::ResolveLayerTurns(const LayerTurns& turns, int frame, CubeFace& face, int& faceQuarterTurns, int& oppositeFaceQuarterTurns)
+{
+	// The middle layer carries the centers, so it sets the rotation of the whole cube. The outer layers then only turn relative to it:
+	// counterclockwise around the axis is clockwise for the face on the negative side, and counterclockwise for the positive one.
+	int rotationQuarterTurns = turns.layers[1] & 3;
+	faceQuarterTurns = (rotationQuarterTurns - turns.layers[2]) & 3;
+	oppositeFaceQuarterTurns = (turns.layers[0] - rotationQuarterTurns) & 3;
+
+	// Find which center currently sits on the positive world face of the axis
+	face = CubeRotation::RotateFace(CubeRotation::Inverse(frame), CubeRotation::GetPositiveFace(turns.axis));
+
+	return CubeRotation::Compose(CubeRotation::FromAxis(turns.axis, rotationQuarterTurns), frame);
+}
+
+CubeState CubeState::GetInverse() const
+{
+	// Slot i holding piece p becomes slot p holding piece i, with the opposite orientation
+	CubeState inverse;
+	for (int slot = 0; slot < NUMBER_OF_EDGES; slot++) {
+		inverse.bytes[EDGE_OFFSET + GetEdge(slot)] = static_cast<uint8_t>(slot | (GetEdgeOrientation(slot) << ORIENTATION_SHIFT));
+	}
+
+	for (int slot = 0; slot < NUMBER_OF_CORNERS; slot++) {
+		inverse.bytes[CORNER_OFFSET + GetCorner(slot)] = static_cast<uint8_t>(slot | (((3 - GetCornerOrientation(slot)) % 3) << ORIENTATION_SHIFT));
+	}
+
+	// Inverting negates the twists, while parities and flips stay the same
+	uint8_t invariants = bytes[INVARIANTS_OFFSET];
+	inverse.bytes[INVARIANTS_OFFSET] = static_cast<uint8_t>((invariants & ~TWIST_SUM_MASK) | ((3 - (invariants & TWIST_SUM_MASK)) % 3));
+
+	// Undoing the moves starts from the frame they ended in, so the inverted pieces are seen through that rotation (the first
+	// symmetries are the rotations), and the frame turns back
+	inverse = CubeSymmetry::Conjugate(inverse, GetFrame());
+	inverse.bytes[FRAME_OFFSET] = static_cast<uint8_t>(CubeRotation::Inverse(GetFrame()));
+	return inverse;
+}
+
+void CubeState::SwapCorners(int slot, int otherSlot)
+{
+	if (slot == otherSlot) {
+		return;
+	}
+
+	uint8_t corner = bytes[CORNER_OFFSET + slot];
+	bytes[CORNER_OFFSET + slot] = bytes[CORNER_OFFSET + otherSlot];
+	bytes[CORNER_OFFSET + otherSlot] = corner;
+	bytes[INVARIANTS_OFFSET] ^= PARITY_MISMATCH_BIT;
+}
+
+void CubeState::SwapEdges(int slot, int otherSlot)
+{
+	if (slot == otherSlot) {
+		return;
+	}
+
+	uint8_t edge = bytes[EDGE_OFFSET + slot];
+	bytes[EDGE_OFFSET + slot] = bytes[EDGE_OFFSET + otherSlot];
+	bytes[EDGE_OFFSET + otherSlot] = edge;
+	bytes[INVARIANTS_OFFSET] ^= PARITY_MISMATCH_BIT;
+}
+
+void CubeState::TwistCorner(int slot, int twist)
+{
+	int orientation = (GetCornerOrientation(slot) + twist) % 3;
+	bytes[CORNER_OFFSET + slot] = static_cast<uint8_t>(GetCorner(slot) | (orientation << ORIENTATION_SHIFT));
+
+	uint8_t invariants = bytes[INVARIANTS_OFFSET];
+	bytes[INVARIANTS_OFFSET] = static_cast<uint8_t>((invariants & ~TWIST_SUM_MASK) | (((invariants & TWIST_SUM_MASK) + twist) % 3));
+}
+
+void CubeState::FlipEdge(int slot)
+{
+	bytes[EDGE_OFFSET + slot] ^= 1 << ORIENTATION_SHIFT;
+	bytes[INVARIANTS_OFFSET] ^= FLIP_SUM_BIT;
+}
+
+void CubeState::UpdateInvariants()
+{
+	uint8_t invariants = 0;
+	int parities[2] = {};
+
+	for (int type = 0; type < 2; type++) {
+		bool isCorner = type == 0;
+		int offset = isCorner ? CORNER_OFFSET : EDGE_OFFSET;
+		int numberOfPieces = isCorner ? NUMBER_OF_CORNERS : NUMBER_OF_EDGES;
+		int modulus = isCorner ? 3 : 2;
+
+		int orientationSum = 0;
+		int seenPieces = 0;
+		for (int slot = 0; slot < numberOfPieces; slot++) {
+			int piece = bytes[offset + slot] & PIECE_MASK;
+			int orientation = bytes[offset + slot] >> ORIENTATION_SHIFT;
+			if (piece >= numberOfPieces || orientation >= modulus || (seenPieces & (1 << piece)) != 0) {
+				invariants |= INVALID_PIECES_BIT;
+			}
+
+			seenPieces |= 1 << piece;
+			orientationSum += orientation;
+		}
+
+		if (isCorner) {
+			invariants |= orientationSum % 3;
+		}
+		else if (orientationSum % 2 != 0) {
+			invariants |= FLIP_SUM_BIT;
+		}
+
+		// The parity of a permutation is the parity of its number of pieces minus its number of cycles
+		if ((invariants & INVALID_PIECES_BIT) == 0) {
+			bool isVisited[NUMBER_OF_EDGES] = {};
+			int numberOfCycles = 0;
+			for (int start = 0; start < numberOfPieces; start++) {
+				if (!isVisited[start]) {
+					numberOfCycles++;
+					for (int slot = start; !isVisited[slot]; slot = bytes[offset + slot] & PIECE_MASK) {
+						isVisited[slot] = true;
+					}
+				}
+			}
+
+			parities[type] = (numberOfPieces - numberOfCycles) & 1;
+		}
+	}
+
+	if (parities[0] != parities[1]) {
+		invariants |= PARITY_MISMATCH_BIT;
+	}
+
+	bytes[INVARIANTS_OFFSET] = invariants;
+}
+
+bool CubeState::IsSolved() const
+{
+	return memcmp(bytes, SOLVED_BYTES, FRAME_OFFSET) == 0;
+}
+
+uint64_t CubeState::GetHash() const
+{
+	uint64_t words[STATE_SIZE / 8];
+	memcpy(words, bytes, STATE_SIZE);
+
+	// Fold the four words together, then finalize with the MurmurHash3 mixer
+	uint64_t hash = words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL) ^ ((words[2] << 29) | (words[2] >> 35)) ^ (words[3] * 0xC2B2AE3D27D4EB4FULL);
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+bool CubeState::operator==(const CubeState& other) const
+{
+	return memcmp(bytes, other.bytes, STATE_SIZE) == 0;
+}
\ No newline at end of file
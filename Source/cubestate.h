@@ -0,0 +1,111 @@
+/*
+	The main purpose of this class is to hold the logical configuration of a 3x3x3 Rubik's cube at the cubie level: which corner and
+	edge cubie sits in each slot, and how it is twisted or flipped. It does not depend on OpenGL and fits in four machine words, so
+	solved checks, comparisons and hashing are a handful of word operations.
+
+	Pieces are tracked relative to the centers (the standard cubie model). Turning a middle slice is the same as turning the two outer
+	layers the other way and rotating the whole cube, so a slice turn only changes corners and edges through face turns and updates
+	frame, the rotation (see CubeRotation) that tells on which world face each center currently sits.
+
+	Packed layout of bytes (one byte per piece, piece index in the low nibble and orientation in the high nibble):
+		bytes 0-11	edges, in UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR slot order (orientation 0-1)
+		bytes 12-15	unused (zero)
+		bytes 16-23	corners, in URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB slot order (orientation 0-2)
+		bytes 24-29	unused (zero)
+		byte 30		invariants
+		byte 31		frame
+	Each 16 byte half can be loaded in a vector register, and a face turn is a byte shuffle followed by an orientation fixup.
+
+	The invariants byte holds what decides whether a configuration can be solved: the corner twist sum, the edge flip sum and whether
+	the corner and edge permutations have different parities. No move changes them (a quarter turn is a 4-cycle of corners and one of
+	edges, whose twists and flips add up to 0), so moves carry the byte along untouched, the editing functions update it in O(1), and
+	IsSolvable is a single comparison. Code writing pieces into bytes directly calls UpdateInvariants afterwards.
+*/
+
+#pragma once
+
+#include "cubemoves.h"
+#include "cuberotation.h"
+
+#include <cstdint>
+
+class CubeState {
+public:
+	enum Corner { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+	enum Edge { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+	static const int NUMBER_OF_CORNERS = 8;
+	static const int NUMBER_OF_EDGES = 12;
+	static const int NUMBER_OF_SLICES = 3; // Slices along each axis
+	static const int NUMBER_OF_FACE_TURNS = 18; // Face turns are indexed face * 3 + (clockwise quarter turns - 1)
+
+	static const int STATE_SIZE = 32;
+	static const int EDGE_OFFSET = 0;
+	static const int CORNER_OFFSET = 16;
+	static const int INVARIANTS_OFFSET = 30;
+	static const int FRAME_OFFSET = 31;
+
+	static const uint8_t PIECE_MASK = 0x0F;
+	static const int ORIENTATION_SHIFT = 4;
+
+	// Bits of the invariants byte, all zero for a configuration that can be solved
+	static const uint8_t TWIST_SUM_MASK = 0x03; // Sum of the corner orientations, modulo 3
+	static const uint8_t FLIP_SUM_BIT = 0x04; // Sum of the edge orientations, modulo 2
+	static const uint8_t PARITY_MISMATCH_BIT = 0x08; // The corner and edge permutations do not have the same parity
+	static const uint8_t INVALID_PIECES_BIT = 0x10; // Some piece is missing or repeated, or has an orientation out of range
+
+	CubeState(); // Creates a solved cube in the identity frame
+
+	// Turns a face (named after its center) clockwise, as seen when looking at that face
+	void ApplyFaceTurn(CubeFace face, int quarterTurns);
+	void ApplyFaceTurn(int faceTurn);
+
+	// Turns a slice of the cube as seen in the world: slices are numbered from the negative side of the axis, and a positive number
+	// of quarter turns is counterclockwise around the positive direction of the axis. This matches the Rubik class selections.
+	void ApplySliceTurn(CubeAxis axis, int slice, int quarterTurns);
+
+	void ApplyLayerTurns(const LayerTurns& turns); // Turns any combination of the layers along a world axis
+	void ApplyMove(int move) { ApplyLayerTurns(CubeMoves::GetLayerTurns(move)); } // Applies a move of the standard notation (see CubeMoves)
+
+	// Expresses layer turns along a world axis, for a cube in the given frame, as clockwise turns of face (named after its center)
+	// and of its opposite face, followed by a change of frame. face is the center sitting on the positive side of the axis.
+	// Returns the new frame.
+	static int ResolveLayerTurns(const LayerTurns& turns, int frame, CubeFace& face, int& faceQuarterTurns, int& oppositeFaceQuarterTurns);
+
+	// Brings the orientations of a packed layout back in range (modulo 2 for edges, 3 for corners) after twists were added to them.
+	// Also works on a twist table alone.
+	static void ReduceOrientations(uint8_t* bytes);
+
+	CubeState GetInverse() const; // The configuration reached from a solved cube by undoing the moves that led to this one
+
+	// Edits for building any configuration, including ones that cannot be solved
+	void SwapCorners(int slot, int otherSlot);
+	void SwapEdges(int slot, int otherSlot);
+	void TwistCorner(int slot, int twist); // Adds twist (0 to 2) to the orientation of the corner in the slot
+	void FlipEdge(int slot);
+
+	void UpdateInvariants(); // Recomputes the invariants byte from the pieces
+	bool IsSolvable() const { return bytes[INVARIANTS_OFFSET] == 0; }
+
+	bool IsSolved() const; // True when every piece is home relative to the centers, whatever the frame
+	uint64_t GetHash() const;
+
+	bool operator==(const CubeState& other) const;
+	bool operator!=(const CubeState& other) const { return !(*this == other); }
+
+	// Getters
+	int GetCorner(int slot) const { return bytes[CORNER_OFFSET + slot] & PIECE_MASK; }
+	int GetCornerOrientation(int slot) const { return bytes[CORNER_OFFSET + slot] >> ORIENTATION_SHIFT; }
+	int GetEdge(int slot) const { return bytes[EDGE_OFFSET + slot] & PIECE_MASK; }
+	int GetEdgeOrientation(int slot) const { return bytes[EDGE_OFFSET + slot] >> ORIENTATION_SHIFT; }
+	int GetFrame() const { return bytes[FRAME_OFFSET]; }
+	int GetInvariants() const { return bytes[INVARIANTS_OFFSET]; }
+
+	// Face turn tables in the packed layout: slot i of the result takes the byte at FACE_TURN_SHUFFLES[turn][i], then adds
+	// FACE_TURN_TWISTS[turn][i] to its orientation (modulo 2 for edges and 3 for corners)
+	static const uint8_t FACE_TURN_SHUFFLES[NUMBER_OF_FACE_TURNS][STATE_SIZE];
+	static const uint8_t FACE_TURN_TWISTS[NUMBER_OF_FACE_TURNS][STATE_SIZE];
+	static const uint8_t SOLVED_BYTES[STATE_SIZE];
+
+	alignas(32) uint8_t bytes[STATE_SIZE];
+};
@@ -0,0 +1,377 @@
+#include "cubesurface.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static const char FACE_NAMES[NUMBER_OF_FACES + 1] = "URFDLB";
+
+CubeSurface::CubeSurface(int size)
+{
+	this->size = size;
+	frame = CubeRotation::IDENTITY;
+	maximumPendingTurns = 0;
+	tracedTurns = 0;
+
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		stickers[face].assign(static_cast<size_t>(size) * size, static_cast<uint8_t>(face));
+		faceTurns[face] = 0;
+	}
+}
+
+CubeSurface::~CubeSurface()
+{
+}
+
+void CubeSurface::ApplySliceTurn(CubeAxis axis, int slice, int quarterTurns)
+{
+	SliceTurn ownTurn = GetOwnSliceTurn(size, frame, axis, slice, quarterTurns);
+	axis = ownTurn.axis;
+	slice = ownTurn.slice;
+	quarterTurns = ownTurn.quarterTurns;
+	if (quarterTurns == 0) {
+		return;
+	}
+
+	if (maximumPendingTurns == 0) {
+		RotateSlice(axis, slice, quarterTurns);
+		return;
+	}
+
+	// Turns of the same slice in a row add up
+	if (!pendingTurns.empty() && pendingTurns.back().axis == axis && pendingTurns.back().slice == slice) {
+		pendingTurns.back().quarterTurns = (pendingTurns.back().quarterTurns + quarterTurns) & 3;
+		if (pendingTurns.back().quarterTurns == 0) {
+			pendingTurns.pop_back();
+		}
+		return;
+	}
+
+	SliceTurn turn;
+	turn.axis = axis;
+	turn.slice = slice;
+	turn.quarterTurns = quarterTurns;
+	pendingTurns.push_back(turn);
+
+	if (static_cast<int>(pendingTurns.size()) >= maximumPendingTurns) {
+		Materialize();
+	}
+}
+
+void CubeSurface::RotateSlice(CubeAxis axis, int slice, int quarterTurns) const
+{
+	quarterTurns &= 3;
+	if (quarterTurns == 0) {
+		return;
+	}
+
+	CubeFace faces[4];
+	int rows[4][2], columns[4][2];
+	GetRing(size, axis, slice, faces, rows, columns);
+
+	// Along the ring every face is read on a straight line, so the indices of its stickers follow a constant step
+	uint8_t* lines[4];
+	ptrdiff_t steps[4];
+	for (int i = 0; i < 4; i++) {
+		ptrdiff_t start = static_cast<ptrdiff_t>(GetIndex(faces[i], rows[i][0], columns[i][0]));
+		steps[i] = static_cast<ptrdiff_t>(GetIndex(faces[i], rows[i][1], columns[i][1])) - start;
+		lines[i] = stickers[faces[i]].data() + start;
+	}
+
+	for (int k = 0; k < size; k++) {
+		uint8_t values[4];
+		for (int i = 0; i < 4; i++) {
+			values[i] = lines[i][k * steps[i]];
+		}
+
+		for (int i = 0; i < 4; i++) {
+			int destination = (i + quarterTurns) & 3;
+			lines[destination][k * steps[destination]] = values[i];
+		}
+	}
+
+	// An outer slice also turns its face
+	for (int side = 0; side < 2; side++) {
+		CubeFace face = side == 0 ? CubeRotation::GetOppositeFace(CubeRotation::GetPositiveFace(axis)) : CubeRotation::GetPositiveFace(axis);
+		if (slice == (side == 0 ? 0 : size - 1)) {
+			faceTurns[face] = static_cast<uint8_t>((faceTurns[face] + GetFaceQuarterTurns(size, face, axis, quarterTurns)) & 3);
+		}
+	}
+}
+
+void CubeSurface::ApplyFaceTurn(CubeFace face, int quarterTurns)
+{
+	// Clockwise seen from outside is counterclockwise around the axis for the face on the negative side, and clockwise for the positive one
+	CubeAxis axis = CubeRotation::GetFaceAxis(face);
+	if (CubeRotation::IsPositiveFace(face)) {
+		ApplySliceTurn(axis, size - 1, -quarterTurns);
+	}
+	else {
+		ApplySliceTurn(axis, 0, quarterTurns);
+	}
+}
+
+void CubeSurface::ApplyRotation(CubeAxis axis, int quarterTurns)
+{
+	frame = static_cast<uint8_t>(CubeRotation::Compose(CubeRotation::FromAxis(axis, quarterTurns), frame));
+}
+
+void CubeSurface::SetMaximumPendingTurns(int maximumPendingTurns)
+{
+	this->maximumPendingTurns = maximumPendingTurns;
+	if (static_cast<int>(pendingTurns.size()) >= maximumPendingTurns) {
+		Materialize();
+	}
+}
+
+void CubeSurface::Materialize() const
+{
+	for (size_t i = 0; i < pendingTurns.size(); i++) {
+		RotateSlice(pendingTurns[i].axis, pendingTurns[i].slice, pendingTurns[i].quarterTurns);
+	}
+	pendingTurns.clear();
+	tracedTurns = 0;
+}
+
+CubeFace CubeSurface::GetSticker(CubeFace face, int row, int column) const
+{
+	GetOwnRowAndColumn(size, frame, face, row, column);
+
+	if (!pendingTurns.empty()) {
+		// Undo the pending turns from the last one, moving the sticker along whenever its slice turns
+		int position[3];
+		GetPosition(size, face, row, column, position);
+
+		for (size_t i = pendingTurns.size(); i-- > 0;) {
+			const SliceTurn& turn = pendingTurns[i];
+			if (position[turn.axis] == turn.slice) {
+				int rotation = CubeRotation::FromAxis(turn.axis, -turn.quarterTurns);
+				int rotatedPosition[3];
+				RotatePosition(size, rotation, position, rotatedPosition);
+
+				face = CubeRotation::RotateFace(rotation, face);
+				for (int j = 0; j < 3; j++) {
+					position[j] = rotatedPosition[j];
+				}
+			}
+		}
+
+		GetRowAndColumn(size, face, position, row, column);
+
+		// Once queries have cost as much as materializing would, materialize so that the next ones are immediate
+		tracedTurns += pendingTurns.size();
+		if (tracedTurns >= pendingTurns.size() * size) {
+			CubeFace sticker = static_cast<CubeFace>(stickers[face][GetIndex(face, row, column)]);
+			Materialize();
+			return sticker;
+		}
+	}
+
+	return static_cast<CubeFace>(stickers[face][GetIndex(face, row, column)]);
+}
+
+bool CubeSurface::IsSolved() const
+{
+	Materialize();
+
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		const std::vector<uint8_t>& faceStickers = stickers[face];
+		for (size_t i = 1; i < faceStickers.size(); i++) {
+			if (faceStickers[i] != faceStickers[0]) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void CubeSurface::Format(char* facelets) const
+{
+	Materialize();
+
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		for (int row = 0; row < size; row++) {
+			for (int column = 0; column < size; column++) {
+				*facelets++ = FACE_NAMES[GetSticker(static_cast<CubeFace>(face), row, column)];
+			}
+		}
+	}
+}
+
+std::string CubeSurface::Format() const
+{
+	std::string facelets(NUMBER_OF_FACES * static_cast<size_t>(size) * size, ' ');
+	Format(&facelets[0]);
+	return facelets;
+}
+
+size_t CubeSurface::GetIndex(CubeFace face, int row, int column) const
+{
+	int storedRow, storedColumn;
+	GetStoredRowAndColumn(size, faceTurns[face], row, column, storedRow, storedColumn);
+
+	return static_cast<size_t>(storedRow) * size + storedColumn;
+}
+
+void CubeSurface::GetStoredRowAndColumn(int size, int faceTurns, int row, int column, int& storedRow, int& storedColumn)
+{
+	// Undo the quarter turns of the face
+	int last = size - 1;
+	storedRow = row;
+	storedColumn = column;
+	switch (faceTurns) {
+	case 1:
+		storedRow = last - column; storedColumn = row;
+		break;
+	case 2:
+		storedRow = last - row; storedColumn = last - column;
+		break;
+	case 3:
+		storedRow = column; storedColumn = last - row;
+		break;
+	}
+}
+
+void CubeSurface::GetRing(int size, CubeAxis axis, int slice, CubeFace faces[4], int rows[4][2], int columns[4][2])
+{
+	int rotation = CubeRotation::FromAxis(axis, 1);
+
+	// The ring starts on a face parallel to the axis, and each quarter turn carries it to the next face
+	faces[0] = CubeRotation::GetPositiveFace(static_cast<CubeAxis>((axis + 1) % NUMBER_OF_AXES));
+	for (int i = 1; i < 4; i++) {
+		faces[i] = CubeRotation::RotateFace(rotation, faces[i - 1]);
+	}
+
+	CubeAxis normalAxis = CubeRotation::GetFaceAxis(faces[0]);
+	CubeAxis lineAxis = static_cast<CubeAxis>(NUMBER_OF_AXES - axis - normalAxis);
+
+	for (int k = 0; k < 2; k++) {
+		int positions[4][3];
+		positions[0][axis] = slice;
+		positions[0][normalAxis] = size - 1;
+		positions[0][lineAxis] = size > 1 ? k : 0; // A cube of size 1 has a single sticker per face
+
+		for (int i = 0; i < 4; i++) {
+			if (i > 0) {
+				RotatePosition(size, rotation, positions[i - 1], positions[i]);
+			}
+
+			GetRowAndColumn(size, faces[i], positions[i], rows[i][k], columns[i][k]);
+		}
+	}
+}
+
+int CubeSurface::GetFaceQuarterTurns(int size, CubeFace face, CubeAxis axis, int quarterTurns)
+{
+	// Find where the top left sticker goes
+	int position[3], rotatedPosition[3];
+	GetPosition(size, face, 0, 0, position);
+	RotatePosition(size, CubeRotation::FromAxis(axis, quarterTurns), position, rotatedPosition);
+
+	int row, column;
+	GetRowAndColumn(size, face, rotatedPosition, row, column);
+
+	return row == 0 ? (column == 0 ? 0 : 1) : (column == 0 ? 3 : 2);
+}
+
+SliceTurn CubeSurface::GetOwnSliceTurn(int size, int frame, CubeAxis axis, int slice, int quarterTurns)
+{
+	// Find which face of the cube sits on the positive side of the world axis. When it is on the negative side of its own axis, the
+	// slices are numbered the other way and turn the other way around it (as in CubeMoves::GetFrameLayerTurns).
+	CubeFace face = CubeRotation::RotateFace(CubeRotation::Inverse(frame), CubeRotation::GetPositiveFace(axis));
+	bool isPositive = CubeRotation::IsPositiveFace(face);
+
+	SliceTurn turn;
+	turn.axis = CubeRotation::GetFaceAxis(face);
+	turn.slice = isPositive ? slice : size - 1 - slice;
+	turn.quarterTurns = (isPositive ? quarterTurns : -quarterTurns) & 3;
+
+	return turn;
+}
+
+void CubeSurface::GetOwnRowAndColumn(int size, int frame, CubeFace& face, int& row, int& column)
+{
+	if (frame == CubeRotation::IDENTITY) {
+		return;
+	}
+
+	// Bring the sticker back from the world to where it is on the cube
+	int inverseFrame = CubeRotation::Inverse(frame);
+	int worldPosition[3], position[3];
+	GetPosition(size, face, row, column, worldPosition);
+	RotatePosition(size, inverseFrame, worldPosition, position);
+
+	face = CubeRotation::RotateFace(inverseFrame, face);
+	GetRowAndColumn(size, face, position, row, column);
+}
+
+void CubeSurface::GetPosition(int size, CubeFace face, int row, int column, int position[3])
+{
+	// Each face is read with the layout of the unfolded net (see CubeFacelets::GetFaceletPosition)
+	int last = size - 1;
+	switch (face) {
+	case FACE_U:
+		position[0] = column; position[1] = last; position[2] = row;
+		break;
+	case FACE_R:
+		position[0] = last; position[1] = last - row; position[2] = last - column;
+		break;
+	case FACE_F:
+		position[0] = column; position[1] = last - row; position[2] = last;
+		break;
+	case FACE_D:
+		position[0] = column; position[1] = 0; position[2] = last - row;
+		break;
+	case FACE_L:
+		position[0] = 0; position[1] = last - row; position[2] = column;
+		break;
+	default:
+		position[0] = last - column; position[1] = last - row; position[2] = 0;
+		break;
+	}
+}
+
+void CubeSurface::GetRowAndColumn(int size, CubeFace face, const int position[3], int& row, int& column)
+{
+	int last = size - 1;
+	switch (face) {
+	case FACE_U:
+		row = position[2]; column = position[0];
+		break;
+	case FACE_R:
+		row = last - position[1]; column = last - position[2];
+		break;
+	case FACE_F:
+		row = last - position[1]; column = position[0];
+		break;
+	case FACE_D:
+		row = last - position[2]; column = position[0];
+		break;
+	case FACE_L:
+		row = last - position[1]; column = position[2];
+		break;
+	default:
+		row = last - position[1]; column = last - position[0];
+		break;
+	}
+}
+
+void CubeSurface::RotatePosition(int size, int rotation, const int position[3], int rotatedPosition[3])
+{
+	// Coordinates are doubled and centered so that the center of the cube is the origin, whatever the parity of the size
+	const int8_t (*matrix)[3] = CubeRotation::GetMatrix(rotation);
+	int last = size - 1;
+
+	int centered[3];
+	for (int i = 0; i < 3; i++) {
+		centered[i] = 2 * position[i] - last;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		rotatedPosition[i] = (matrix[i][0] * centered[0] + matrix[i][1] * centered[1] + matrix[i][2] * centered[2] + last) / 2;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+	The main purpose of this class is to simulate huge NxNxN cubes (N in the hundreds or thousands) by storing only what can be seen:
+	the six faces, N * N stickers each, one byte per sticker holding the face whose color it has. Rubik keeps one Cube object per cubie
+	and a matrix of N^3 positions, which does not scale past small sizes; here N = 1000 takes 6 MB.
+
+	Stickers are laid out like the facelet strings of CubeFacelets (faces in U, R, F, D, L, B order, each read row by row as on the
+	unfolded net), so for N = 3 Format gives the same string as CubeFacelets::Format. Turning a slice moves the 4N stickers of its ring.
+	When an outer slice turns, the face on that side turns as well, which only changes its orientation tag: the number of quarter turns
+	to apply when reading its array. A move therefore costs O(N) whatever slice it turns.
+
+	How the cube is held in the world is its frame, one of the 24 cube rotations (see CubeRotation), as for Rubik::viewFrame. Turns,
+	GetSticker and Format use the axes and faces of the world, which the frame maps to the own axes of the cube that the arrays, orientation
+	tags and pending turns use. A whole cube rotation (x, y or z) therefore only changes the frame, in O(1) whatever the size.
+
+	With SetMaximumPendingTurns, turns are only recorded, and GetSticker traces the sticker back through the pending turns to find where
+	it was in the arrays. Long replays then cost nothing until they are looked at. Each query costs one step per pending turn, so the
+	pending turns are applied (materialized) once queries have spent as many steps as that would take (about size steps per turn), when
+	there are more of them than the maximum, and before reading the whole surface.
+*/
+
+#pragma once
+
+#include "cubemoves.h"
+#include "cuberotation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CubeSurface {
+public:
+	CubeSurface(int size); // Creates a solved cube with size cubies along each edge
+	virtual ~CubeSurface();
+
+	// Same conventions as CubeState: slices are numbered from the negative side of the axis, and a positive number of quarter turns
+	// is counterclockwise around the positive direction of the axis
+	void ApplySliceTurn(CubeAxis axis, int slice, int quarterTurns);
+	void ApplyFaceTurn(CubeFace face, int quarterTurns); // Turns the outer layer of a face clockwise, as seen when looking at that face
+	void ApplyRotation(CubeAxis axis, int quarterTurns); // Rotates the whole cube around a world axis by changing the frame
+
+	void SetMaximumPendingTurns(int maximumPendingTurns); // 0 applies every turn right away (default)
+	void Materialize() const; // Applies the pending turns to the stickers
+
+	bool IsSolved() const; // True when every face has a single color, whatever the orientation of the whole cube
+
+	// Writes 6 * size * size characters, without null terminator
+	void Format(char* facelets) const;
+	std::string Format() const;
+
+	// Getters
+	int GetSize() const { return size; }
+	int GetFrame() const { return frame; }
+	CubeFace GetSticker(CubeFace face, int row, int column) const;
+	int GetMaximumPendingTurns() const { return maximumPendingTurns; }
+	int GetNumberOfPendingTurns() const { return static_cast<int>(pendingTurns.size()); }
+	size_t GetMemoryUsage() const { return NUMBER_OF_FACES * stickers[0].size() * sizeof(uint8_t); } // Bytes taken by the stickers
+
+	// Geometry of the stickers of a cube with size cubies along each edge, shared with PersistentSurface and Rubik::GetStickers.
+	// Conversions between the row and column of a sticker and the position of its cubie (0 to size - 1 along each axis):
+	static void GetPosition(int size, CubeFace face, int row, int column, int position[3]);
+	static void GetRowAndColumn(int size, CubeFace face, const int position[3], int& row, int& column);
+	static void RotatePosition(int size, int rotation, const int position[3], int rotatedPosition[3]); // Around the center of the cube
+
+	// Row and column at which the sticker seen at row and column was when its face, turned faceTurns times clockwise since, was laid out
+	static void GetStoredRowAndColumn(int size, int faceTurns, int row, int column, int& storedRow, int& storedColumn);
+
+	// The four faces around a slice, each carried to the next one by a quarter turn, and the first two stickers of the ring on each
+	static void GetRing(int size, CubeAxis axis, int slice, CubeFace faces[4], int rows[4][2], int columns[4][2]);
+
+	// Clockwise quarter turns of a face when the outer slice it belongs to turns by quarterTurns around axis
+	static int GetFaceQuarterTurns(int size, CubeFace face, CubeAxis axis, int quarterTurns);
+
+	// Conversions from the world to the own axes of a cube held in frame: the turn of the same slice, and the face, row and column at
+	// which the sticker seen on a face is
+	static SliceTurn GetOwnSliceTurn(int size, int frame, CubeAxis axis, int slice, int quarterTurns);
+	static void GetOwnRowAndColumn(int size, int frame, CubeFace& face, int& row, int& column);
+
+protected:
+	int size;
+	uint8_t frame; // Rotation carrying the own axes of the cube to the world
+
+	// Materializing does not change what the cube looks like, so it is allowed on a const cube
+	mutable std::vector<uint8_t> stickers[NUMBER_OF_FACES];
+	mutable uint8_t faceTurns[NUMBER_OF_FACES]; // Orientation tags: clockwise quarter turns of each face since its array was laid out
+
+	int maximumPendingTurns;
+	mutable std::vector<SliceTurn> pendingTurns;
+	mutable size_t tracedTurns; // Steps spent by queries on the pending turns since they were last materialized
+
+	void RotateSlice(CubeAxis axis, int slice, int quarterTurns) const; // Moves the stickers right away
+
+	size_t GetIndex(CubeFace face, int row, int column) const; // Index in the array of the face of the sticker seen at row and column
+};
\ No newline at end of file
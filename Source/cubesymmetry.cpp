@@ -0,0 +1,328 @@
+#include "cubesymmetry.h"
+#include "cubefacelets.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <cstdint>
+#include <cstring>
+
+const CubeFace CubeSymmetry::CORNER_FACES[CubeState::NUMBER_OF_CORNERS][3] = {
+	{ FACE_U, FACE_R, FACE_F }, // URF
+	{ FACE_U, FACE_F, FACE_L }, // UFL
+	{ FACE_U, FACE_L, FACE_B }, // ULB
+	{ FACE_U, FACE_B, FACE_R }, // UBR
+	{ FACE_D, FACE_F, FACE_R }, // DFR
+	{ FACE_D, FACE_L, FACE_F }, // DLF
+	{ FACE_D, FACE_B, FACE_L }, // DBL
+	{ FACE_D, FACE_R, FACE_B }  // DRB
+};
+
+const CubeFace CubeSymmetry::EDGE_FACES[CubeState::NUMBER_OF_EDGES][2] = {
+	{ FACE_U, FACE_R }, { FACE_U, FACE_F }, { FACE_U, FACE_L }, { FACE_U, FACE_B },
+	{ FACE_D, FACE_R }, { FACE_D, FACE_F }, { FACE_D, FACE_L }, { FACE_D, FACE_B },
+	{ FACE_F, FACE_R }, { FACE_F, FACE_L }, { FACE_B, FACE_L }, { FACE_B, FACE_R }
+};
+
+static const int CORNER_BYTES = 3 << CubeState::ORIENTATION_SHIFT; // Piece bytes of corners are below this
+static const int EDGE_BYTES = 2 << CubeState::ORIENTATION_SHIFT;
+
+// Lookup tables derived from the symmetry matrices, built on first use
+struct SymmetryTables {
+	int8_t matrices[CubeSymmetry::NUMBER_OF_SYMMETRIES][3][3];
+	uint8_t composition[CubeSymmetry::NUMBER_OF_SYMMETRIES][CubeSymmetry::NUMBER_OF_SYMMETRIES];
+	uint8_t inverse[CubeSymmetry::NUMBER_OF_SYMMETRIES];
+	uint8_t faceMap[CubeSymmetry::NUMBER_OF_SYMMETRIES][NUMBER_OF_FACES];
+	uint8_t frames[CubeSymmetry::NUMBER_OF_SYMMETRIES][CubeRotation::NUMBER_OF_ROTATIONS]; // Conjugate of each frame
+
+	// Slot that each slot is carried to, and the byte that each piece byte in a slot becomes there
+	uint8_t cornerSlots[CubeSymmetry::NUMBER_OF_SYMMETRIES][CubeState::NUMBER_OF_CORNERS];
+	uint8_t edgeSlots[CubeSymmetry::NUMBER_OF_SYMMETRIES][CubeState::NUMBER_OF_EDGES];
+	uint8_t cornerBytes[CubeSymmetry::NUMBER_OF_SYMMETRIES][CubeState::NUMBER_OF_CORNERS][CORNER_BYTES];
+	uint8_t edgeBytes[CubeSymmetry::NUMBER_OF_SYMMETRIES][CubeState::NUMBER_OF_EDGES][EDGE_BYTES];
+
+	SymmetryTables()
+	{
+		// The matrix of a symmetry is the rotation times the reflection x -> -x when there is one
+		for (int symmetry = 0; symmetry < CubeSymmetry::NUMBER_OF_SYMMETRIES; symmetry++) {
+			const int8_t (*rotation)[3] = CubeRotation::GetMatrix(CubeSymmetry::GetRotation(symmetry));
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					matrices[symmetry][i][j] = static_cast<int8_t>(j == 0 && CubeSymmetry::IsReflection(symmetry) ? -rotation[i][j] : rotation[i][j]);
+				}
+			}
+		}
+
+		for (int symmetry = 0; symmetry < CubeSymmetry::NUMBER_OF_SYMMETRIES; symmetry++) {
+			for (int face = 0; face < NUMBER_OF_FACES; face++) {
+				int normal[3], mappedNormal[3];
+				CubeFacelets::GetFaceNormal(static_cast<CubeFace>(face), normal);
+				Transform(matrices[symmetry], normal, mappedNormal);
+				faceMap[symmetry][face] = static_cast<uint8_t>(FindFace(mappedNormal));
+			}
+
+			for (int other = 0; other < CubeSymmetry::NUMBER_OF_SYMMETRIES; other++) {
+				int8_t product[3][3];
+				Multiply(matrices[symmetry], matrices[other], product);
+				composition[symmetry][other] = static_cast<uint8_t>(FindMatrix(product, matrices, CubeSymmetry::NUMBER_OF_SYMMETRIES));
+				if (composition[symmetry][other] == CubeSymmetry::IDENTITY) {
+					inverse[symmetry] = static_cast<uint8_t>(other);
+				}
+			}
+		}
+
+		for (int symmetry = 0; symmetry < CubeSymmetry::NUMBER_OF_SYMMETRIES; symmetry++) {
+			// Matrices are orthogonal, so the inverse is the transpose
+			int8_t inverseMatrix[3][3];
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					inverseMatrix[i][j] = matrices[symmetry][j][i];
+				}
+			}
+
+			for (int frame = 0; frame < CubeRotation::NUMBER_OF_ROTATIONS; frame++) {
+				int8_t product[3][3], conjugate[3][3];
+				Multiply(CubeRotation::GetMatrix(frame), inverseMatrix, product);
+				Multiply(matrices[symmetry], product, conjugate);
+				frames[symmetry][frame] = static_cast<uint8_t>(FindMatrix(conjugate, matrices, CubeRotation::NUMBER_OF_ROTATIONS)); // The first symmetries are the rotations
+			}
+
+			CreatePieceTables<3>(CubeSymmetry::CORNER_FACES, CubeState::NUMBER_OF_CORNERS, faceMap[symmetry], cornerSlots[symmetry], cornerBytes[symmetry][0], CORNER_BYTES);
+			CreatePieceTables<2>(CubeSymmetry::EDGE_FACES, CubeState::NUMBER_OF_EDGES, faceMap[symmetry], edgeSlots[symmetry], edgeBytes[symmetry][0], EDGE_BYTES);
+		}
+	}
+
+	// Moves the stickers of every piece byte in every slot to their mapped faces, recolored by the same map, and reads back which slot,
+	// piece and orientation that is
+	template <int N>
+	static void CreatePieceTables(const CubeFace faces[][N], int numberOfPieces, const uint8_t* faceMap, uint8_t* slots, uint8_t* bytes, int bytesPerSlot)
+	{
+		for (int slot = 0; slot < numberOfPieces; slot++) {
+			int mappedSlot = FindPiece<N>(faces, numberOfPieces, faceMap, slot);
+			slots[slot] = static_cast<uint8_t>(mappedSlot);
+
+			for (int piece = 0; piece < numberOfPieces; piece++) {
+				int mappedPiece = FindPiece<N>(faces, numberOfPieces, faceMap, piece);
+
+				for (int orientation = 0; orientation < N; orientation++) {
+					// Sticker 0 of the mapped piece sits where the sticker of the original piece with the same mapped color went
+					int mappedOrientation = 0;
+					for (int i = 0; i < N; i++) {
+						if (faceMap[faces[piece][i]] == faces[mappedPiece][0]) {
+							CubeFace mappedFace = static_cast<CubeFace>(faceMap[faces[slot][(i + orientation) % N]]);
+							while (faces[mappedSlot][mappedOrientation] != mappedFace) {
+								mappedOrientation++;
+							}
+						}
+					}
+
+					bytes[slot * bytesPerSlot + (orientation << CubeState::ORIENTATION_SHIFT) + piece] = static_cast<uint8_t>(mappedPiece | (mappedOrientation << CubeState::ORIENTATION_SHIFT));
+				}
+			}
+		}
+	}
+
+	template <int N>
+	static int FindPiece(const CubeFace faces[][N], int numberOfPieces, const uint8_t* faceMap, int piece)
+	{
+		for (int candidate = 0; candidate < numberOfPieces; candidate++) {
+			int matches = 0;
+			for (int i = 0; i < N; i++) {
+				for (int j = 0; j < N; j++) {
+					matches += faceMap[faces[piece][i]] == faces[candidate][j];
+				}
+			}
+
+			if (matches == N) {
+				return candidate;
+			}
+		}
+
+		return -1;
+	}
+
+	static void Transform(const int8_t matrix[3][3], const int vector[3], int result[3])
+	{
+		for (int i = 0; i < 3; i++) {
+			result[i] = matrix[i][0] * vector[0] + matrix[i][1] * vector[1] + matrix[i][2] * vector[2];
+		}
+	}
+
+	static void Multiply(const int8_t left[3][3], const int8_t right[3][3], int8_t result[3][3])
+	{
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				result[i][j] = static_cast<int8_t>(left[i][0] * right[0][j] + left[i][1] * right[1][j] + left[i][2] * right[2][j]);
+			}
+		}
+	}
+
+	static int FindMatrix(const int8_t matrix[3][3], const int8_t matrices[][3][3], int numberOfMatrices)
+	{
+		for (int i = 0; i < numberOfMatrices; i++) {
+			if (memcmp(matrix, matrices[i], 9) == 0) {
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	static int FindFace(const int normal[3])
+	{
+		for (int face = 0; face < NUMBER_OF_FACES; face++) {
+			int candidate[3];
+			CubeFacelets::GetFaceNormal(static_cast<CubeFace>(face), candidate);
+			if (memcmp(candidate, normal, sizeof(candidate)) == 0) {
+				return face;
+			}
+		}
+
+		return -1;
+	}
+};
+
+static const SymmetryTables& GetSymmetryTables()
+{
+	static const SymmetryTables tables;
+	return tables;
+}
+
+int CubeSymmetry::Compose(int outer, int inner)
+{
+	return GetSymmetryTables().composition[outer][inner];
+}
+
+int CubeSymmetry::Inverse(int symmetry)
+{
+	return GetSymmetryTables().inverse[symmetry];
+}
+
+CubeFace CubeSymmetry::MapFace(int symmetry, CubeFace face)
+{
+	return static_cast<CubeFace>(GetSymmetryTables().faceMap[symmetry][face]);
+}
+
+int CubeSymmetry::ConjugateFaceTurn(int faceTurn, int symmetry)
+{
+	int quarterTurns = faceTurn % 3 + 1;
+	if (IsReflection(symmetry)) {
+		quarterTurns = 4 - quarterTurns;
+	}
+
+	return MapFace(symmetry, static_cast<CubeFace>(faceTurn / 3)) * 3 + quarterTurns - 1;
+}
+
+uint64_t CubeSymmetry::GetAxisSymmetries(CubeAxis axis)
+{
+	CubeFace face = CubeRotation::GetPositiveFace(axis);
+
+	uint64_t symmetries = 0;
+	for (int symmetry = 0; symmetry < NUMBER_OF_SYMMETRIES; symmetry++) {
+		CubeFace mappedFace = MapFace(symmetry, face);
+		if (mappedFace == face || mappedFace == CubeRotation::GetOppositeFace(face)) {
+			symmetries |= 1ULL << symmetry;
+		}
+	}
+
+	return symmetries;
+}
+
+void CubeSymmetry::ConjugatePieces(const uint8_t* bytes, int symmetry, uint8_t* conjugateBytes)
+{
+	const SymmetryTables& tables = GetSymmetryTables();
+
+	const uint8_t* edgeSlots = tables.edgeSlots[symmetry];
+	for (int slot = 0; slot < CubeState::NUMBER_OF_EDGES; slot++) {
+		conjugateBytes[CubeState::EDGE_OFFSET + edgeSlots[slot]] = tables.edgeBytes[symmetry][slot][bytes[CubeState::EDGE_OFFSET + slot]];
+	}
+
+	const uint8_t* cornerSlots = tables.cornerSlots[symmetry];
+	for (int slot = 0; slot < CubeState::NUMBER_OF_CORNERS; slot++) {
+		conjugateBytes[CubeState::CORNER_OFFSET + cornerSlots[slot]] = tables.cornerBytes[symmetry][slot][bytes[CubeState::CORNER_OFFSET + slot]];
+	}
+
+	// A mirror image has its twists reversed, the other invariants do not depend on the point of view
+	uint8_t invariants = bytes[CubeState::INVARIANTS_OFFSET];
+	if (IsReflection(symmetry)) {
+		invariants = static_cast<uint8_t>((invariants & ~CubeState::TWIST_SUM_MASK) | ((3 - (invariants & CubeState::TWIST_SUM_MASK)) % 3));
+	}
+	conjugateBytes[CubeState::INVARIANTS_OFFSET] = invariants;
+}
+
+CubeState CubeSymmetry::Conjugate(const CubeState& state, int symmetry)
+{
+	CubeState conjugate;
+	ConjugatePieces(state.bytes, symmetry, conjugate.bytes);
+	conjugate.bytes[CubeState::FRAME_OFFSET] = GetSymmetryTables().frames[symmetry][state.GetFrame()];
+
+	return conjugate;
+}
+
+void CubeSymmetry::FindCanonical(const uint8_t* bytes, uint8_t* bestBytes, int& bestSymmetry)
+{
+	// Only the corners, edges and invariants are compared, the unused bytes stay zero
+	uint8_t conjugateBytes[CubeState::STATE_SIZE] = {};
+	for (int symmetry = 0; symmetry < NUMBER_OF_SYMMETRIES; symmetry++) {
+		ConjugatePieces(bytes, symmetry, conjugateBytes);
+
+		if (memcmp(conjugateBytes, bestBytes, CubeState::FRAME_OFFSET) < 0) {
+			memcpy(bestBytes, conjugateBytes, CubeState::FRAME_OFFSET);
+			bestSymmetry = symmetry;
+		}
+	}
+}
+
+CubeState CubeSymmetry::GetCanonical(const CubeState& state)
+{
+	int symmetry;
+	return GetCanonical(state, symmetry);
+}
+
+CubeState CubeSymmetry::GetCanonical(const CubeState& state, int& symmetry)
+{
+	CubeState canonical = state;
+	canonical.bytes[CubeState::FRAME_OFFSET] = CubeRotation::IDENTITY;
+	symmetry = IDENTITY;
+
+	FindCanonical(state.bytes, canonical.bytes, symmetry);
+	return canonical;
+}
+
+CubeState CubeSymmetry::GetCanonicalWithInverse(const CubeState& state)
+{
+	int symmetry;
+	bool isInverted;
+	return GetCanonicalWithInverse(state, symmetry, isInverted);
+}
+
+CubeState CubeSymmetry::GetCanonicalWithInverse(const CubeState& state, int& symmetry, bool& isInverted)
+{
+	CubeState canonical = GetCanonical(state, symmetry);
+	isInverted = false;
+
+	int inverseSymmetry = -1;
+	CubeState inverse = state.GetInverse();
+	FindCanonical(inverse.bytes, canonical.bytes, inverseSymmetry);
+
+	if (inverseSymmetry >= 0) {
+		symmetry = inverseSymmetry;
+		isInverted = true;
+	}
+
+	return canonical;
+}
+
+uint64_t CubeSymmetry::GetSymmetries(const CubeState& state)
+{
+	uint64_t symmetries = 0;
+
+	uint8_t conjugateBytes[CubeState::STATE_SIZE] = {};
+	for (int symmetry = 0; symmetry < NUMBER_OF_SYMMETRIES; symmetry++) {
+		ConjugatePieces(state.bytes, symmetry, conjugateBytes);
+		if (memcmp(conjugateBytes, state.bytes, CubeState::FRAME_OFFSET) == 0) {
+			symmetries |= 1ULL << symmetry;
+		}
+	}
+
+	return symmetries;
+}
\ No newline at end of file
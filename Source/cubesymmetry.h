@@ -0,0 +1,60 @@
+/*
+	The main purpose of this class is to reduce cube states by the 48 symmetries of the cube: the 24 rotations (see CubeRotation), each
+	alone or preceded by the reflection through the plane between the L and R faces (x -> -x). Symmetry s is rotation s % 24, with that
+	reflection first when s >= 24, so symmetry 0 is the identity.
+
+	Conjugating a state by a symmetry transforms the whole cube, pieces and sticker colors alike, which gives the same position seen from
+	another side or in a mirror. It is reached by the transformed moves (see ConjugateFaceTurn), so it takes exactly as many moves to
+	solve. Conjugation only goes through tables built on first use: for each symmetry, where each slot goes and what each piece byte
+	(piece and orientation, as packed in CubeState) becomes in it.
+
+	The canonical representative of a state is its smallest conjugate, comparing the packed pieces. Counting the inverse state as
+	equivalent too (it is solved by the reversed moves) gives 96 candidates. States sharing a representative are the same position up
+	to symmetry, which divides table sizes and search work by up to 48 (or 96). Like ranks, representatives are relative to the centers:
+	their frame is the identity.
+*/
+
+#pragma once
+
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <cstdint>
+
+class CubeSymmetry {
+public:
+	static const int NUMBER_OF_SYMMETRIES = 48;
+	static const int IDENTITY = 0;
+	static const uint64_t ALL_SYMMETRIES = (1ULL << NUMBER_OF_SYMMETRIES) - 1;
+
+	// Symmetry equal to applying inner first, then outer
+	static int Compose(int outer, int inner);
+	static int Inverse(int symmetry);
+
+	static bool IsReflection(int symmetry) { return symmetry >= CubeRotation::NUMBER_OF_ROTATIONS; }
+	static int GetRotation(int symmetry) { return symmetry % CubeRotation::NUMBER_OF_ROTATIONS; }
+
+	static CubeFace MapFace(int symmetry, CubeFace face); // Face that the given face is carried to by the symmetry
+	static int ConjugateFaceTurn(int faceTurn, int symmetry); // A reflection also reverses the direction of the turn
+	static uint64_t GetAxisSymmetries(CubeAxis axis); // Mask of the 16 symmetries that map the axis to itself
+
+	// Conjugates the pieces, and the frame as well
+	static CubeState Conjugate(const CubeState& state, int symmetry);
+
+	// symmetry (and isInverted) tell which conjugate is the representative: Conjugate(state, symmetry), or Conjugate of the inverse state
+	static CubeState GetCanonical(const CubeState& state);
+	static CubeState GetCanonical(const CubeState& state, int& symmetry);
+	static CubeState GetCanonicalWithInverse(const CubeState& state);
+	static CubeState GetCanonicalWithInverse(const CubeState& state, int& symmetry, bool& isInverted);
+
+	static uint64_t GetSymmetries(const CubeState& state); // Mask of the symmetries leaving the pieces of the state unchanged
+
+private:
+	static const CubeFace CORNER_FACES[CubeState::NUMBER_OF_CORNERS][3]; // Faces of each corner slot, starting with the U or D one, then clockwise
+	static const CubeFace EDGE_FACES[CubeState::NUMBER_OF_EDGES][2];
+
+	static void ConjugatePieces(const uint8_t* bytes, int symmetry, uint8_t* conjugateBytes); // On the corner and edge bytes of a packed state
+	static void FindCanonical(const uint8_t* bytes, uint8_t* bestBytes, int& bestSymmetry); // Keeps bestBytes when no conjugate is smaller
+
+	friend struct SymmetryTables;
+};
\ No newline at end of file
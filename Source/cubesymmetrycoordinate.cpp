@@ -0,0 +1,90 @@
+#include "cubesymmetrycoordinate.h"
+#include "cubecoordinates.h"
+#include "cubestate.h"
+#include "cubesymmetry.h"
+
+#include <cstdint>
+#include <vector>
+
+static const uint16_t NO_CLASS = 0xFFFF;
+
+CubeSymmetryCoordinate::CubeSymmetryCoordinate(CubeCoordinates::Coordinate coordinate, uint64_t symmetries)
+{
+	this->coordinate = coordinate;
+
+	// Complete the mask into a group
+	symmetries |= 1ULL << CubeSymmetry::IDENTITY;
+	uint64_t previousSymmetries = 0;
+	while (symmetries != previousSymmetries) {
+		previousSymmetries = symmetries;
+		for (int outer = 0; outer < CubeSymmetry::NUMBER_OF_SYMMETRIES; outer++) {
+			for (int inner = 0; inner < CubeSymmetry::NUMBER_OF_SYMMETRIES; inner++) {
+				if (((previousSymmetries >> outer) & 1) && ((previousSymmetries >> inner) & 1)) {
+					symmetries |= 1ULL << CubeSymmetry::Compose(outer, inner);
+				}
+			}
+		}
+	}
+	this->symmetries = symmetries;
+
+	CreateConjugates();
+	CreateClasses();
+}
+
+CubeSymmetryCoordinate::~CubeSymmetryCoordinate()
+{
+}
+
+void CubeSymmetryCoordinate::CreateConjugates()
+{
+	int size = CubeCoordinates::GetSize(coordinate);
+
+	for (int symmetry = 0; symmetry < CubeSymmetry::NUMBER_OF_SYMMETRIES; symmetry++) {
+		if (((symmetries >> symmetry) & 1) == 0) {
+			continue;
+		}
+
+		std::vector<uint16_t>& table = conjugates[symmetry];
+		table.resize(size);
+
+		for (int value = 0; value < size; value++) {
+			CubeState state;
+			CubeCoordinates::SetCoordinate(state, coordinate, value);
+			table[value] = static_cast<uint16_t>(CubeCoordinates::GetCoordinate(CubeSymmetry::Conjugate(state, symmetry), coordinate));
+		}
+	}
+}
+
+void CubeSymmetryCoordinate::CreateClasses()
+{
+	int size = CubeCoordinates::GetSize(coordinate);
+	classes.assign(size, NO_CLASS);
+	valueSymmetries.assign(size, CubeSymmetry::IDENTITY);
+
+	// Values are visited in increasing order, so the first value of each class is its smallest one
+	for (int value = 0; value < size; value++) {
+		if (classes[value] != NO_CLASS) {
+			continue;
+		}
+
+		uint16_t equivalenceClass = static_cast<uint16_t>(representatives.size());
+		representatives.push_back(static_cast<uint16_t>(value));
+		classSymmetries.push_back(0);
+
+		for (int symmetry = 0; symmetry < CubeSymmetry::NUMBER_OF_SYMMETRIES; symmetry++) {
+			if (((symmetries >> symmetry) & 1) == 0) {
+				continue;
+			}
+
+			int conjugate = conjugates[symmetry][value];
+			if (conjugate == value) {
+				classSymmetries[equivalenceClass] |= 1ULL << symmetry;
+			}
+
+			if (classes[conjugate] == NO_CLASS) {
+				classes[conjugate] = equivalenceClass;
+				valueSymmetries[conjugate] = static_cast<uint8_t>(symmetry);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*
+	The main purpose of this class is to reduce a coordinate (see CubeCoordinates) by a group of symmetries (see CubeSymmetry): values
+	that are conjugates of each other fall into one equivalence class, and a value is stored as its class plus the symmetry that carries
+	the class representative to it. Tables indexed by class instead of value are smaller by up to the number of symmetries.
+
+	This only makes sense when the coordinate of a conjugate state depends on nothing but the coordinate of the state, which holds for:
+		CORNER_PERMUTATION										any symmetries (984 classes under all 48)
+		CORNER_ORIENTATION, UD_SLICE, UD_SLICE_SORTED			symmetries keeping the UD axis (CubeSymmetry::GetAxisSymmetries(AXIS_Y))
+	The edge orientation also depends on where the slice edges are, so it cannot be reduced on its own.
+*/
+
+#pragma once
+
+#include "cubecoordinates.h"
+#include "cubestate.h"
+#include "cubesymmetry.h"
+
+#include <cstdint>
+#include <vector>
+
+class CubeSymmetryCoordinate {
+public:
+	// symmetries is a mask of CubeSymmetry indices, completed into the group it generates
+	CubeSymmetryCoordinate(CubeCoordinates::Coordinate coordinate, uint64_t symmetries);
+	virtual ~CubeSymmetryCoordinate();
+
+	int Conjugate(int value, int symmetry) const { return conjugates[symmetry][value]; } // symmetry must belong to the group
+
+	int GetClass(int value) const { return classes[value]; }
+	int GetSymmetry(int value) const { return valueSymmetries[value]; } // value is Conjugate(GetRepresentative(GetClass(value)), GetSymmetry(value))
+	int GetClass(const CubeState& state) const { return GetClass(CubeCoordinates::GetCoordinate(state, coordinate)); }
+
+	// Getters
+	CubeCoordinates::Coordinate GetCoordinate() const { return coordinate; }
+	uint64_t GetSymmetries() const { return symmetries; }
+
+	int GetNumberOfClasses() const { return static_cast<int>(representatives.size()); }
+	int GetRepresentative(int equivalenceClass) const { return representatives[equivalenceClass]; } // Smallest value of the class
+	uint64_t GetClassSymmetries(int equivalenceClass) const { return classSymmetries[equivalenceClass]; } // Symmetries leaving the representative unchanged
+
+protected:
+	CubeCoordinates::Coordinate coordinate;
+	uint64_t symmetries;
+
+	std::vector<uint16_t> conjugates[CubeSymmetry::NUMBER_OF_SYMMETRIES]; // Empty for symmetries outside of the group
+
+	std::vector<uint16_t> classes;
+	std::vector<uint8_t> valueSymmetries;
+
+	std::vector<uint16_t> representatives;
+	std::vector<uint64_t> classSymmetries;
+
+	void CreateConjugates();
+	void CreateClasses();
+};
\ No newline at end of file
@@ -0,0 +1,593 @@
+#include "cubeverifier.h"
+#include "cubealgorithm.h"
+#include "cubebatch.h"
+#include "cubebitslice.h"
+#include "cubefacelets.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+#include "cubesurface.h"
+#include "cubezobrist.h"
+#include "moveengine.h"
+#include "persistentsurface.h"
+#include "rubik.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+const char* const CubeVerifier::ENGINE_NAMES[NUMBER_OF_ENGINES] = {
+	"MoveEngine sequence", "MoveEngine batch", "MoveEngine algorithm", "CubeBatch", "CubeBitslice", "CubeZobrist", "CubeSurface",
+	"PersistentSurface"
+};
+
+// Reference Rubik of one size, driven without OpenGL (shader 0) nor animation. A thread builds one and resets it before every replay.
+class RubikReference {
+public:
+	virtual ~RubikReference() {}
+
+	virtual std::string Apply(const CubeState& start, const std::vector<uint8_t>& moves) = 0; // Stickers after the moves from start
+	virtual std::string Apply(const std::vector<CubeVerifier::SurfaceTurn>& turns) = 0; // Stickers after the turns from solved
+
+	static RubikReference* Create(int size); // Null past CubeVerifier::MAXIMUM_RUBIK_SIZE
+};
+
+template <int N>
+class SizedRubikReference : public RubikReference {
+public:
+	SizedRubikReference() : rubik(glm::vec3(0.0f, 0.0f, 0.0f), 0) {}
+
+	virtual std::string Apply(const CubeState& start, const std::vector<uint8_t>& moves)
+	{
+		rubik.Reset();
+		rubik.SetViewCubeState(start);
+		for (size_t i = 0; i < moves.size(); i++) {
+			rubik.ApplyMove(moves[i], false);
+		}
+
+		return rubik.GetStickers();
+	}
+
+	virtual std::string Apply(const std::vector<CubeVerifier::SurfaceTurn>& turns)
+	{
+		rubik.Reset();
+		for (size_t i = 0; i < turns.size(); i++) {
+			const SliceTurn& worldTurn = turns[i].turn;
+			if (turns[i].isRotation) {
+				rubik.ApplyRotation(worldTurn.axis, worldTurn.quarterTurns);
+				continue;
+			}
+
+			// Rubik turns slices in its own axes: find the face of the cube held on the positive side of the world axis. When it is on
+			// the negative side of its own axis, the slices are numbered and turned the other way.
+			CubeFace face = CubeRotation::RotateFace(CubeRotation::Inverse(rubik.GetViewFrame()), CubeRotation::GetPositiveFace(worldTurn.axis));
+			SliceTurn turn;
+			turn.axis = CubeRotation::GetFaceAxis(face);
+			if (CubeRotation::IsPositiveFace(face)) {
+				turn.slice = worldTurn.slice;
+				turn.quarterTurns = worldTurn.quarterTurns;
+			}
+			else {
+				turn.slice = N - worldTurn.slice - turns[i].numberOfSlices;
+				turn.quarterTurns = -worldTurn.quarterTurns & 3;
+			}
+
+			rubik.ApplyWideTurn(turn, turns[i].numberOfSlices, false);
+		}
+
+		return rubik.GetStickers();
+	}
+
+protected:
+	Rubik<N> rubik;
+};
+
+RubikReference* RubikReference::Create(int size)
+{
+	switch (size) {
+	case 2: return new SizedRubikReference<2>();
+	case 3: return new SizedRubikReference<3>();
+	case 4: return new SizedRubikReference<4>();
+	case 5: return new SizedRubikReference<5>();
+	case 6: return new SizedRubikReference<6>();
+	case 7: return new SizedRubikReference<7>();
+	case 8: return new SizedRubikReference<8>();
+	case 9: return new SizedRubikReference<9>();
+	case 10: return new SizedRubikReference<10>();
+	default: return nullptr;
+	}
+}
+
+// Stickers of a surface model turned from solved
+template <typename Surface>
+static std::string GetSurfaceStickers(int size, const std::vector<CubeVerifier::SurfaceTurn>& turns)
+{
+	Surface surface(size);
+	for (size_t i = 0; i < turns.size(); i++) {
+		if (turns[i].isRotation) {
+			surface.ApplyRotation(turns[i].turn.axis, turns[i].turn.quarterTurns);
+			continue;
+		}
+
+		for (int slice = turns[i].turn.slice; slice < turns[i].turn.slice + turns[i].numberOfSlices; slice++) {
+			surface.ApplySliceTurn(turns[i].turn.axis, slice, turns[i].turn.quarterTurns);
+		}
+	}
+
+	return surface.Format();
+}
+
+CubeVerifier::CubeVerifier(Engine engine, uint64_t seed) : moveEngine()
+{
+	this->engine = engine;
+	this->instructionSet = moveEngine.GetInstructionSet();
+	this->seed = seed;
+	size = 3;
+	SetNumberOfThreads(static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+CubeVerifier::CubeVerifier(Engine engine, MoveEngine::InstructionSet instructionSet, uint64_t seed) : moveEngine(instructionSet)
+{
+	this->engine = engine;
+	this->instructionSet = moveEngine.GetInstructionSet();
+	this->seed = seed;
+	size = 3;
+	SetNumberOfThreads(static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+CubeVerifier::~CubeVerifier()
+{
+}
+
+CubeVerifier::Report CubeVerifier::Run(uint64_t numberOfCases, int movesPerCase) const
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Give each thread a contiguous run of cases, and keep one for the calling thread
+	uint64_t numberOfWorkers = static_cast<uint64_t>(numberOfThreads);
+	if (numberOfWorkers > numberOfCases) {
+		numberOfWorkers = numberOfCases > 0 ? numberOfCases : 1;
+	}
+
+	std::vector<Report> reports(static_cast<size_t>(numberOfWorkers));
+	std::vector<std::thread> workers;
+	uint64_t firstCase = 0;
+	for (uint64_t i = 0; i < numberOfWorkers; i++) {
+		uint64_t endCase = numberOfCases * (i + 1) / numberOfWorkers;
+
+		if (i + 1 < numberOfWorkers) {
+			workers.push_back(std::thread(&CubeVerifier::RunCases, this, firstCase, endCase, movesPerCase, &reports[i]));
+		}
+		else {
+			RunCases(firstCase, endCase, movesPerCase, &reports[i]);
+		}
+
+		firstCase = endCase;
+	}
+
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+
+	Report report;
+	report.numberOfCases = 0;
+	report.numberOfMoves = 0;
+	report.numberOfMismatches = 0;
+	for (size_t i = 0; i < reports.size(); i++) {
+		report.numberOfCases += reports[i].numberOfCases;
+		report.numberOfMoves += reports[i].numberOfMoves;
+		report.numberOfMismatches += reports[i].numberOfMismatches;
+
+		for (size_t j = 0; j < reports[i].counterexamples.size() && report.counterexamples.size() < MAXIMUM_COUNTEREXAMPLES; j++) {
+			report.counterexamples.push_back(reports[i].counterexamples[j]);
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	report.movesPerSecond = seconds > 0.0 ? report.numberOfMoves / seconds : 0.0;
+
+	// Shrink the failures once the run is over, they are rare and each one replays the moves many times
+	RubikReference* reference = CreateReference();
+	for (size_t i = 0; i < report.counterexamples.size(); i++) {
+		Counterexample& counterexample = report.counterexamples[i];
+
+		if (GetIsSurfaceEngine(engine)) {
+			MinimizeMoves(counterexample, counterexample.turns, reference);
+		}
+		else {
+			CubeState solvedState;
+			if (!Replay(solvedState, counterexample.moves, reference, nullptr)) {
+				counterexample.start = solvedState;
+			}
+
+			MinimizeMoves(counterexample, counterexample.moves, reference);
+		}
+
+		Replay(counterexample, reference, &counterexample);
+	}
+	delete reference;
+
+	return report;
+}
+
+void CubeVerifier::RunCases(uint64_t firstCase, uint64_t endCase, int movesPerCase, Report* report) const
+{
+	report->numberOfCases = endCase - firstCase;
+	report->numberOfMoves = 0;
+	report->numberOfMismatches = 0;
+
+	// The sets and the reference are used by this thread alone, and kept from one case to the next
+	RubikReference* reference = CreateReference();
+	CubeBatch* batch = engine == CUBE_BATCH ? new CubeBatch(STATES_PER_CASE, instructionSet) : nullptr;
+	CubeBitslice* bitslice = engine == CUBE_BITSLICE ? new CubeBitslice(STATES_PER_CASE, instructionSet) : nullptr;
+	if (batch != nullptr) {
+		batch->SetNumberOfThreads(1);
+	}
+	if (bitslice != nullptr) {
+		bitslice->SetNumberOfThreads(1);
+	}
+
+	std::vector<uint8_t> moves;
+	std::vector<SurfaceTurn> turns;
+	std::vector<CubeState> starts, states;
+
+	for (uint64_t caseIndex = firstCase; caseIndex < endCase; caseIndex++) {
+		int mismatch = -1;
+
+		if (GetIsSurfaceEngine(engine)) {
+			CreateCase(caseIndex, movesPerCase, turns);
+			starts.assign(1, CubeState());
+			report->numberOfMoves += turns.size();
+
+			if (!Replay(turns, reference, nullptr)) {
+				mismatch = 0;
+			}
+		}
+		else {
+			CreateCase(caseIndex, movesPerCase, moves, starts);
+			report->numberOfMoves += starts.size() * moves.size();
+
+			if (engine == ZOBRIST) {
+				for (size_t i = 0; i < starts.size() && mismatch < 0; i++) {
+					if (!Replay(starts[i], moves, reference, nullptr)) {
+						mismatch = static_cast<int>(i);
+					}
+				}
+			}
+			else {
+				states = starts;
+				ApplyEngine(states, moves, batch, bitslice);
+
+				for (size_t i = 0; i < starts.size() && mismatch < 0; i++) {
+					CubeState expected;
+					CubeFacelets::Parse(reference->Apply(starts[i], moves), expected);
+					expected.UpdateInvariants();
+					if (states[i] != expected) {
+						mismatch = static_cast<int>(i);
+					}
+				}
+			}
+		}
+
+		if (mismatch >= 0) {
+			report->numberOfMismatches++;
+
+			if (report->counterexamples.size() < MAXIMUM_COUNTEREXAMPLES) {
+				Counterexample counterexample;
+				counterexample.caseIndex = caseIndex;
+				counterexample.start = starts[mismatch];
+				counterexample.moves = moves;
+				counterexample.turns = turns;
+				counterexample.expectedHash = 0;
+				counterexample.actualHash = 0;
+				report->counterexamples.push_back(counterexample);
+			}
+		}
+	}
+
+	delete reference;
+	delete batch;
+	delete bitslice;
+}
+
+bool CubeVerifier::Replay(const CubeState& start, const std::vector<uint8_t>& moves, Counterexample* counterexample) const
+{
+	RubikReference* reference = CreateReference();
+	bool isMatch = Replay(start, moves, reference, counterexample);
+	delete reference;
+	return isMatch;
+}
+
+bool CubeVerifier::Replay(const std::vector<SurfaceTurn>& turns, Counterexample* counterexample) const
+{
+	RubikReference* reference = CreateReference();
+	bool isMatch = Replay(turns, reference, counterexample);
+	delete reference;
+	return isMatch;
+}
+
+bool CubeVerifier::Replay(const Counterexample& candidate, RubikReference* reference, Counterexample* counterexample) const
+{
+	if (GetIsSurfaceEngine(engine)) {
+		return Replay(candidate.turns, reference, counterexample);
+	}
+
+	return Replay(candidate.start, candidate.moves, reference, counterexample);
+}
+
+bool CubeVerifier::Replay(const CubeState& start, const std::vector<uint8_t>& moves, RubikReference* reference, Counterexample* counterexample) const
+{
+	std::string expectedFacelets = reference->Apply(start, moves);
+	CubeState expected;
+	CubeFacelets::Parse(expectedFacelets, expected);
+	expected.UpdateInvariants();
+	uint64_t expectedHash = CubeZobrist::GetHash(expected);
+
+	CubeState actual = start;
+	uint64_t actualHash = 0;
+	bool isMatch;
+
+	if (engine == ZOBRIST) {
+		actualHash = CubeZobrist::GetHash(actual);
+		for (size_t i = 0; i < moves.size(); i++) {
+			CubeZobrist::ApplyMove(actual, actualHash, moves[i]);
+		}
+
+		isMatch = actual == expected && actualHash == expectedHash;
+	}
+	else {
+		CubeBatch* batch = engine == CUBE_BATCH ? new CubeBatch(1, instructionSet) : nullptr;
+		CubeBitslice* bitslice = engine == CUBE_BITSLICE ? new CubeBitslice(1, instructionSet) : nullptr;
+
+		std::vector<CubeState> states(1, start);
+		ApplyEngine(states, moves, batch, bitslice);
+
+		delete batch;
+		delete bitslice;
+
+		actual = states[0];
+		actualHash = CubeZobrist::GetHash(actual);
+		isMatch = actual == expected;
+	}
+
+	if (counterexample != nullptr) {
+		counterexample->expectedFacelets = expectedFacelets;
+		counterexample->actualFacelets = FormatFacelets(actual);
+		counterexample->expectedHash = expectedHash;
+		counterexample->actualHash = actualHash;
+	}
+
+	return isMatch;
+}
+
+bool CubeVerifier::Replay(const std::vector<SurfaceTurn>& turns, RubikReference* reference, Counterexample* counterexample) const
+{
+	// Past the sizes of Rubik, the two surfaces check each other
+	std::string expectedFacelets;
+	if (reference != nullptr) {
+		expectedFacelets = reference->Apply(turns);
+	}
+	else {
+		expectedFacelets = engine == SURFACE ? GetSurfaceStickers<PersistentSurface>(size, turns) : GetSurfaceStickers<CubeSurface>(size, turns);
+	}
+
+	std::string actualFacelets = engine == SURFACE ? GetSurfaceStickers<CubeSurface>(size, turns) : GetSurfaceStickers<PersistentSurface>(size, turns);
+
+	if (counterexample != nullptr) {
+		counterexample->expectedFacelets = expectedFacelets;
+		counterexample->actualFacelets = actualFacelets;
+		counterexample->expectedHash = 0;
+		counterexample->actualHash = 0;
+	}
+
+	return actualFacelets == expectedFacelets;
+}
+
+std::vector<uint8_t> CubeVerifier::Minimize(const CubeState& start, const std::vector<uint8_t>& moves) const
+{
+	Counterexample candidate;
+	candidate.start = start;
+	candidate.moves = moves;
+
+	RubikReference* reference = CreateReference();
+	MinimizeMoves(candidate, candidate.moves, reference);
+	delete reference;
+
+	return candidate.moves;
+}
+
+std::vector<CubeVerifier::SurfaceTurn> CubeVerifier::Minimize(const std::vector<SurfaceTurn>& turns) const
+{
+	Counterexample candidate;
+	candidate.turns = turns;
+
+	RubikReference* reference = CreateReference();
+	MinimizeMoves(candidate, candidate.turns, reference);
+	delete reference;
+
+	return candidate.turns;
+}
+
+template <typename Move>
+void CubeVerifier::MinimizeMoves(Counterexample& candidate, std::vector<Move>& moves, RubikReference* reference) const
+{
+	// Try dropping every run of chunk moves, halving chunk down to single moves
+	for (size_t chunk = moves.size() / 2; chunk >= 1; chunk /= 2) {
+		size_t i = 0;
+		while (i + chunk <= moves.size()) {
+			std::vector<Move> dropped(moves.begin() + i, moves.begin() + i + chunk);
+			moves.erase(moves.begin() + i, moves.begin() + i + chunk);
+
+			// The engine agrees with the reference without them, so they are part of the failure
+			if (Replay(candidate, reference, nullptr)) {
+				moves.insert(moves.begin() + i, dropped.begin(), dropped.end());
+				i += chunk;
+			}
+		}
+	}
+}
+
+void CubeVerifier::ApplyEngine(std::vector<CubeState>& states, const std::vector<uint8_t>& moves, CubeBatch* batch, CubeBitslice* bitslice) const
+{
+	switch (engine) {
+	case MOVE_SEQUENCE:
+		for (size_t i = 0; i < states.size(); i++) {
+			moveEngine.Apply(states[i], moves.data(), moves.size());
+		}
+		break;
+
+	case MOVE_BATCH:
+		for (size_t i = 0; i < moves.size(); i++) {
+			moveEngine.Apply(states.data(), states.size(), moves[i]);
+		}
+		break;
+
+	case MOVE_ALGORITHM:
+		moveEngine.Apply(states.data(), states.size(), CubeAlgorithm(moves));
+		break;
+
+	case CUBE_BATCH:
+		for (size_t i = 0; i < states.size(); i++) {
+			batch->SetState(i, states[i]);
+		}
+		batch->Apply(CubeAlgorithm(moves));
+		for (size_t i = 0; i < states.size(); i++) {
+			states[i] = batch->GetState(i);
+		}
+		break;
+
+	case CUBE_BITSLICE:
+		// The states of a case share their frame (see CreateCase)
+		bitslice->SetFrame(states[0].GetFrame());
+		for (size_t i = 0; i < states.size(); i++) {
+			bitslice->SetState(i, states[i]);
+		}
+		bitslice->Apply(moves.data(), moves.size());
+		for (size_t i = 0; i < states.size(); i++) {
+			states[i] = bitslice->GetState(i);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void CubeVerifier::CreateCase(uint64_t caseIndex, int movesPerCase, std::vector<uint8_t>& moves, std::vector<CubeState>& starts) const
+{
+	uint64_t random = seed ^ (caseIndex * 0xD1B54A32D192ED03ULL);
+
+	moves.resize(movesPerCase);
+	for (int i = 0; i < movesPerCase; i++) {
+		moves[i] = static_cast<uint8_t>(GetNextRandom(random) % CubeMoves::NUMBER_OF_MOVES);
+	}
+
+	starts.assign(STATES_PER_CASE, CubeState());
+
+	uint8_t frame = static_cast<uint8_t>(GetNextRandom(random) % CubeRotation::NUMBER_OF_ROTATIONS);
+	for (size_t i = 0; i < starts.size(); i++) {
+		for (int j = 0; j < SCRAMBLE_LENGTH; j++) {
+			starts[i].ApplyFaceTurn(static_cast<int>(GetNextRandom(random) % CubeState::NUMBER_OF_FACE_TURNS));
+		}
+
+		// Pieces are relative to the centers, so any frame goes with them. Sets of cubes turned together may need a single one.
+		if (engine != CUBE_BITSLICE) {
+			frame = static_cast<uint8_t>(GetNextRandom(random) % CubeRotation::NUMBER_OF_ROTATIONS);
+		}
+		starts[i].bytes[CubeState::FRAME_OFFSET] = frame;
+	}
+}
+
+void CubeVerifier::CreateCase(uint64_t caseIndex, int movesPerCase, std::vector<SurfaceTurn>& turns) const
+{
+	uint64_t random = seed ^ (caseIndex * 0xD1B54A32D192ED03ULL);
+
+	turns.resize(movesPerCase);
+	for (int i = 0; i < movesPerCase; i++) {
+		SurfaceTurn& turn = turns[i];
+		turn.turn.axis = static_cast<CubeAxis>(GetNextRandom(random) % NUMBER_OF_AXES);
+		turn.turn.quarterTurns = static_cast<int>(GetNextRandom(random) % 3) + 1;
+
+		// One turn in eight rotates the whole cube, so that the others go through every frame
+		turn.isRotation = GetNextRandom(random) % 8 == 0;
+		if (turn.isRotation) {
+			turn.turn.slice = 0;
+			turn.numberOfSlices = size;
+			continue;
+		}
+
+		// One turn in four of the others is wide, which Rubik turns with a single gather
+		turn.numberOfSlices = GetNextRandom(random) % 4 == 0 ? static_cast<int>(GetNextRandom(random) % size) + 1 : 1;
+		turn.turn.slice = static_cast<int>(GetNextRandom(random) % (size - turn.numberOfSlices + 1));
+	}
+}
+
+std::string CubeVerifier::FormatMoves(const Counterexample& counterexample)
+{
+	static const char AXIS_NAMES[NUMBER_OF_AXES + 1] = "XYZ";
+	static const char ROTATION_NAMES[NUMBER_OF_AXES + 1] = "xyz";
+
+	std::string result;
+	for (size_t i = 0; i < counterexample.moves.size(); i++) {
+		result += (result.empty() ? "" : " ") + std::string(CubeMoves::GetName(counterexample.moves[i]));
+	}
+
+	// Axis, slices and quarter turns, e.g. Y3-5+1 turns slices 3 to 5 of the Y axis by a quarter turn and y+1 rotates the whole cube
+	for (size_t i = 0; i < counterexample.turns.size(); i++) {
+		const SurfaceTurn& turn = counterexample.turns[i];
+		if (turn.isRotation) {
+			result += (result.empty() ? "" : " ") + std::string(1, ROTATION_NAMES[turn.turn.axis]) + "+" + std::to_string(turn.turn.quarterTurns);
+			continue;
+		}
+
+		result += (result.empty() ? "" : " ") + std::string(1, AXIS_NAMES[turn.turn.axis]) + std::to_string(turn.turn.slice);
+		if (turn.numberOfSlices > 1) {
+			result += "-" + std::to_string(turn.turn.slice + turn.numberOfSlices - 1);
+		}
+		result += "+" + std::to_string(turn.turn.quarterTurns);
+	}
+
+	return result;
+}
+
+const char* CubeVerifier::GetEngineName(Engine engine)
+{
+	return engine >= 0 && engine < NUMBER_OF_ENGINES ? ENGINE_NAMES[engine] : "";
+}
+
+RubikReference* CubeVerifier::CreateReference() const
+{
+	return RubikReference::Create(GetIsSurfaceEngine(engine) ? size : 3);
+}
+
+void CubeVerifier::SetNumberOfThreads(int numberOfThreads)
+{
+	this->numberOfThreads = numberOfThreads < 1 ? 1 : numberOfThreads;
+}
+
+void CubeVerifier::SetSize(int size)
+{
+	this->size = size < 1 ? 1 : size;
+}
+
+uint64_t CubeVerifier::GetNextRandom(uint64_t& state)
+{
+	// SplitMix64
+	uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+std::string CubeVerifier::FormatFacelets(const CubeState& state)
+{
+	// Formatting looks the pieces up in tables, which only hold the ones that exist
+	CubeState checkedState = state;
+	checkedState.UpdateInvariants();
+	return (checkedState.GetInvariants() & CubeState::INVALID_PIECES_BIT) == 0 ? CubeFacelets::Format(state) : std::string();
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+	The main purpose of this class is to prove that an optimized move engine turns cubes exactly like the reference before it is used in
+	its place. It replays random move sequences through the engine and through the reference, compares every resulting state, and shrinks
+	each mismatch to a short counterexample.
+
+	The reference is Rubik itself, driven without an OpenGL context (shader 0, no animation): its table driven rubikMatrix turns and the
+	orientations of its cubes, read back as stickers (see Rubik::GetStickers). Its CubeState, which Rubik keeps in sync through
+	CubeZobrist, is not used. The engines turning 3x3x3 CubeStates are compared with Rubik<3> through facelet strings. The NxNxN
+	engines (CubeSurface and PersistentSurface) are compared with Rubik<size> for every size Rubik is instantiated for (up to
+	MAXIMUM_RUBIK_SIZE), which checks Rubik<N> in return, and with each other past that. Each thread keeps a single reference Rubik and
+	resets it between replays (see RubikReference in cubeverifier.cpp).
+
+	Work is split into cases. A 3x3x3 case is a random sequence of moves of the notation applied to STATES_PER_CASE random start states,
+	and the engines that turn sets of cubes get the whole case at once, so their vector and bitsliced paths are the ones checked. A
+	surface case is a random sequence of slice turns, some of them wide, and whole cube rotations, which only change the frame of the
+	surfaces and the view frame of Rubik, applied to a solved cube. Cases only depend on the seed and their
+	index, so a run can be repeated exactly, and they are spread over every core.
+
+	A mismatching case is shrunk before it is reported: it starts from the solved cube instead if the engine still fails from there, then
+	moves are dropped, in big chunks first and then one by one, for as long as the engine keeps disagreeing with the reference.
+*/
+
+#pragma once
+
+#include "cubebatch.h"
+#include "cubebitslice.h"
+#include "cubemoves.h"
+#include "cubestate.h"
+#include "moveengine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class RubikReference;
+
+class CubeVerifier {
+public:
+	enum Engine {
+		MOVE_SEQUENCE, // MoveEngine turning one state through a sequence
+		MOVE_BATCH, // MoveEngine turning many states by one move
+		MOVE_ALGORITHM, // MoveEngine turning many states by a compiled algorithm (see CubeAlgorithm)
+		CUBE_BATCH, // CubeBatch
+		CUBE_BITSLICE, // CubeBitslice
+		ZOBRIST, // Incremental hashes of CubeZobrist, also checked against hashing from scratch
+		SURFACE, // CubeSurface of any size, against Rubik<size> or PersistentSurface
+		PERSISTENT_SURFACE, // PersistentSurface of any size, against Rubik<size> or CubeSurface
+		NUMBER_OF_ENGINES
+	};
+
+	static const int STATES_PER_CASE = 256;
+	static const int SCRAMBLE_LENGTH = 30; // Random face turns of the start states
+	static const size_t MAXIMUM_COUNTEREXAMPLES = 16; // Mismatches past this are counted but not minimized
+	static const int MAXIMUM_RUBIK_SIZE = 10; // Largest Rubik<N> instantiated in rubik.cpp
+
+	// Turn of a surface case: numberOfSlices neighbouring slices from turn.slice, turned together, in the axes of the world
+	struct SurfaceTurn {
+		SliceTurn turn;
+		int numberOfSlices;
+		bool isRotation; // Whole cube rotation (x, y or z) around turn.axis instead, with every slice
+	};
+
+	struct Counterexample {
+		uint64_t caseIndex;
+		CubeState start; // Solved for the surface engines
+		std::vector<uint8_t> moves; // Minimized, for the 3x3x3 engines
+		std::vector<SurfaceTurn> turns; // Minimized, for the surface engines
+		std::string expectedFacelets; // See CubeFacelets, or the layout of CubeSurface for the surface engines
+		std::string actualFacelets; // Empty when the engine gave pieces that do not exist
+		uint64_t expectedHash; // CubeZobrist hashes (from scratch for the reference), which only differ with equal facelets when ZOBRIST fails
+		uint64_t actualHash;
+	};
+
+	struct Report {
+		uint64_t numberOfCases;
+		uint64_t numberOfMoves; // Cube moves checked (states times moves, or slice turns for the surface engines)
+		uint64_t numberOfMismatches; // Cases that failed
+		std::vector<Counterexample> counterexamples;
+		double movesPerSecond;
+	};
+
+	CubeVerifier(Engine engine, uint64_t seed); // Uses the best instruction set supported by the CPU
+	CubeVerifier(Engine engine, MoveEngine::InstructionSet instructionSet, uint64_t seed);
+	virtual ~CubeVerifier();
+
+	Report Run(uint64_t numberOfCases, int movesPerCase) const;
+
+	// Turns start by moves (or a solved cube by turns) with the engine and with the reference, and returns whether they match. When
+	// counterexample is not null, its facelets and hashes receive what each side gave.
+	bool Replay(const CubeState& start, const std::vector<uint8_t>& moves, Counterexample* counterexample) const;
+	bool Replay(const std::vector<SurfaceTurn>& turns, Counterexample* counterexample) const;
+	std::vector<uint8_t> Minimize(const CubeState& start, const std::vector<uint8_t>& moves) const;
+	std::vector<SurfaceTurn> Minimize(const std::vector<SurfaceTurn>& turns) const;
+
+	static const char* GetEngineName(Engine engine);
+	static bool GetIsSurfaceEngine(Engine engine) { return engine == SURFACE || engine == PERSISTENT_SURFACE; }
+	static bool GetHasInstructionSets(Engine engine) { return engine <= CUBE_BITSLICE; } // Has a kernel for each MoveEngine::InstructionSet
+	static std::string FormatMoves(const Counterexample& counterexample); // Moves of the notation, or turns written as axis, slices and quarter turns
+
+	// Setters
+	void SetNumberOfThreads(int numberOfThreads);
+	void SetSize(int size); // Cubies along each edge of the surface engines (3 by default)
+
+	// Getters
+	Engine GetEngine() const { return engine; }
+	MoveEngine::InstructionSet GetInstructionSet() const { return instructionSet; }
+	uint64_t GetSeed() const { return seed; }
+	int GetNumberOfThreads() const { return numberOfThreads; }
+	int GetSize() const { return size; }
+
+protected:
+	Engine engine;
+	MoveEngine::InstructionSet instructionSet;
+	uint64_t seed;
+	int numberOfThreads;
+	int size;
+
+	MoveEngine moveEngine;
+
+	void RunCases(uint64_t firstCase, uint64_t endCase, int movesPerCase, Report* report) const; // Work done by one thread
+
+	// Turns states by moves with an engine that gives CubeStates back. The sets must hold as many states for the engines using them.
+	void ApplyEngine(std::vector<CubeState>& states, const std::vector<uint8_t>& moves, CubeBatch* batch, CubeBitslice* bitslice) const;
+
+	// Random moves and start states, or random turns, of a case, the same on every run with the same seed
+	void CreateCase(uint64_t caseIndex, int movesPerCase, std::vector<uint8_t>& moves, std::vector<CubeState>& starts) const;
+	void CreateCase(uint64_t caseIndex, int movesPerCase, std::vector<SurfaceTurn>& turns) const;
+
+	// Same as the public functions, with the reference Rubik of the calling thread (null past MAXIMUM_RUBIK_SIZE). The first one
+	// replays the start and moves of candidate, or its turns for the surface engines.
+	bool Replay(const Counterexample& candidate, RubikReference* reference, Counterexample* counterexample) const;
+	bool Replay(const CubeState& start, const std::vector<uint8_t>& moves, RubikReference* reference, Counterexample* counterexample) const;
+	bool Replay(const std::vector<SurfaceTurn>& turns, RubikReference* reference, Counterexample* counterexample) const;
+
+	// Drops moves of candidate, which holds the list moves, for as long as it keeps failing
+	template <typename Move>
+	void MinimizeMoves(Counterexample& candidate, std::vector<Move>& moves, RubikReference* reference) const;
+
+	RubikReference* CreateReference() const; // Rubik of the size checked by the engine, null if there is none
+
+	static uint64_t GetNextRandom(uint64_t& state);
+	static std::string FormatFacelets(const CubeState& state);
+
+private:
+	static const char* const ENGINE_NAMES[NUMBER_OF_ENGINES];
+};
\ No newline at end of file
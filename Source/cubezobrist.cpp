@@ -0,0 +1,153 @@
+#include "cubezobrist.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Keys of every byte value and bytes turned by every face, built on first use
+struct ZobristTables {
+	uint64_t keys[CubeState::STATE_SIZE][CubeZobrist::NUMBER_OF_VALUES];
+	uint8_t faceSlots[NUMBER_OF_FACES][CubeZobrist::SLOTS_PER_FACE];
+
+	ZobristTables()
+	{
+		uint64_t seed = 0x5A0B4157C0BE0001ULL;
+		for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+			for (int value = 0; value < CubeZobrist::NUMBER_OF_VALUES; value++) {
+				keys[i][value] = GetNextRandom(seed);
+			}
+		}
+
+		// The bytes a quarter turn takes from another slot, or turns in place, are the ones every turn of that face changes
+		for (int face = 0; face < NUMBER_OF_FACES; face++) {
+			const uint8_t* shuffle = CubeState::FACE_TURN_SHUFFLES[face * 3];
+			const uint8_t* twist = CubeState::FACE_TURN_TWISTS[face * 3];
+
+			int numberOfSlots = 0;
+			for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+				if ((shuffle[i] != i || twist[i] != 0) && numberOfSlots < CubeZobrist::SLOTS_PER_FACE) {
+					faceSlots[face][numberOfSlots++] = static_cast<uint8_t>(i);
+				}
+			}
+		}
+	}
+
+	// SplitMix64, which is enough for keys that only need to look independent
+	static uint64_t GetNextRandom(uint64_t& seed)
+	{
+		uint64_t value = (seed += 0x9E3779B97F4A7C15ULL);
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		return value ^ (value >> 31);
+	}
+};
+
+static const ZobristTables& GetZobristTables()
+{
+	static const ZobristTables tables;
+	return tables;
+}
+
+uint64_t CubeZobrist::GetHash(const CubeState& state)
+{
+	const ZobristTables& tables = GetZobristTables();
+
+	uint64_t hash = 0;
+	for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+		hash ^= tables.keys[i][state.bytes[i] & (NUMBER_OF_VALUES - 1)];
+	}
+
+	return hash;
+}
+
+void CubeZobrist::ApplyFaceTurn(CubeState& state, uint64_t& hash, int faceTurn)
+{
+	const ZobristTables& tables = GetZobristTables();
+	const uint8_t* slots = tables.faceSlots[faceTurn / 3];
+
+	for (int i = 0; i < SLOTS_PER_FACE; i++) {
+		hash ^= tables.keys[slots[i]][state.bytes[slots[i]]];
+	}
+
+	state.ApplyFaceTurn(faceTurn);
+
+	for (int i = 0; i < SLOTS_PER_FACE; i++) {
+		hash ^= tables.keys[slots[i]][state.bytes[slots[i]]];
+	}
+}
+
+void CubeZobrist::ApplySliceTurn(CubeState& state, uint64_t& hash, CubeAxis axis, int slice, int quarterTurns)
+{
+	LayerTurns turns;
+	turns.axis = axis;
+	for (int i = 0; i < CubeState::NUMBER_OF_SLICES; i++) {
+		turns.layers[i] = static_cast<int8_t>(i == slice ? quarterTurns : 0);
+	}
+
+	ApplyLayerTurns(state, hash, turns);
+}
+
+void CubeZobrist::ApplyLayerTurns(CubeState& state, uint64_t& hash, const LayerTurns& turns)
+{
+	CubeFace face;
+	int faceQuarterTurns, oppositeFaceQuarterTurns;
+	int frame = CubeState::ResolveLayerTurns(turns, state.GetFrame(), face, faceQuarterTurns, oppositeFaceQuarterTurns);
+
+	if (faceQuarterTurns != 0) {
+		ApplyFaceTurn(state, hash, face * 3 + faceQuarterTurns - 1);
+	}
+	if (oppositeFaceQuarterTurns != 0) {
+		ApplyFaceTurn(state, hash, CubeRotation::GetOppositeFace(face) * 3 + oppositeFaceQuarterTurns - 1);
+	}
+
+	if (frame != state.GetFrame()) {
+		const uint64_t* frameKeys = GetZobristTables().keys[CubeState::FRAME_OFFSET];
+		hash ^= frameKeys[state.GetFrame()] ^ frameKeys[frame];
+		state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+	}
+}
+
+CubeZobrist::Benchmark CubeZobrist::MeasureOverhead(int numberOfMoves, CubeMoves::Family firstFamily, CubeMoves::Family endFamily)
+{
+	int firstMove = firstFamily * 3;
+	int numberOfKinds = (endFamily - firstFamily) * 3;
+
+	uint64_t seed = 0;
+	std::vector<uint8_t> moves(numberOfMoves);
+	for (int i = 0; i < numberOfMoves; i++) {
+		moves[i] = static_cast<uint8_t>(firstMove + ZobristTables::GetNextRandom(seed) % numberOfKinds);
+	}
+	GetZobristTables();
+
+	Benchmark benchmark;
+	double* nanoseconds[3] = { &benchmark.plainNanoseconds, &benchmark.incrementalNanoseconds, &benchmark.fullNanoseconds };
+	uint64_t checksum = 0; // Keeps the work from being optimized away
+
+	for (int pass = 0; pass < 3; pass++) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		CubeState state;
+		uint64_t hash = GetHash(state);
+		for (int i = 0; i < numberOfMoves; i++) {
+			if (pass == 1) {
+				ApplyMove(state, hash, moves[i]);
+			}
+			else {
+				state.ApplyMove(moves[i]);
+				hash ^= pass == 2 ? GetHash(state) : state.bytes[i & (CubeState::STATE_SIZE - 1)];
+			}
+		}
+		checksum ^= hash;
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		*nanoseconds[pass] = numberOfMoves > 0 ? seconds * 1e9 / numberOfMoves : 0.0;
+	}
+
+	volatile uint64_t sink = checksum;
+	(void)sink;
+
+	return benchmark;
+}
\ No newline at end of file
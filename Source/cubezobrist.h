@@ -0,0 +1,49 @@
+/*
+	The main purpose of this class is to give every cube state a 64-bit Zobrist hash that follows the moves incrementally, so replays
+	can be deduplicated, returns to earlier positions detected and caches keyed without rehashing whole states.
+
+	Each byte of the packed CubeState layout has one random key per value it can hold, and the hash of a state is the XOR of the keys of
+	its bytes. A face turn only changes the 8 bytes of the pieces of that face (4 edges and 4 corners), so it updates the hash by XORing
+	out their old keys and XORing in the new ones, and a move does that for at most two faces plus the frame byte. The keys come from a
+	fixed seed, so hashes are the same from one run to the next and can be stored.
+
+	Like CubeState::operator==, the hash covers the frame: the same pieces seen from another side hash differently. It is not the value of
+	CubeState::GetHash, which folds the whole state at once.
+
+	The incremental update reads two keys per slot of every face a move turns. A face turn, or a wide turn, changes one face (16 keys
+	instead of the 32 of a rehash) and a whole cube rotation only the frame (2 keys), but a slice turn changes two faces, which is as many
+	keys as rehashing the 32 bytes and costs about the same. MeasureOverhead times each kind of move separately.
+*/
+
+#pragma once
+
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+
+#include <cstdint>
+
+class CubeZobrist {
+public:
+	static const int NUMBER_OF_VALUES = 64; // Every byte of a CubeState is below this
+	static const int SLOTS_PER_FACE = 8;
+
+	// Time per move of applying moves to a state alone, while updating its hash incrementally, and while rehashing it after every move
+	struct Benchmark {
+		double plainNanoseconds;
+		double incrementalNanoseconds;
+		double fullNanoseconds;
+	};
+
+	static uint64_t GetHash(const CubeState& state); // Hash computed from scratch
+	static uint64_t GetSolvedHash() { return GetHash(CubeState()); } // Hash of the solved cube in the identity frame
+
+	// Turn state like the CubeState functions of the same names, and update hash (the hash of state before the turn) to match
+	static void ApplyFaceTurn(CubeState& state, uint64_t& hash, int faceTurn);
+	static void ApplySliceTurn(CubeState& state, uint64_t& hash, CubeAxis axis, int slice, int quarterTurns);
+	static void ApplyLayerTurns(CubeState& state, uint64_t& hash, const LayerTurns& turns);
+	static void ApplyMove(CubeState& state, uint64_t& hash, int move) { ApplyLayerTurns(state, hash, CubeMoves::GetLayerTurns(move)); }
+
+	// Applies the same random moves, of the families from firstFamily to before endFamily, three ways and times them
+	static Benchmark MeasureOverhead(int numberOfMoves, CubeMoves::Family firstFamily, CubeMoves::Family endFamily);
+};
\ No newline at end of file
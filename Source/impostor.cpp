@@ -0,0 +1,302 @@
+#include "impostor.h"
+#include "cube.h"
+#include "scenesnapshot.h"
+#include "utils.h"
+
+#include <cmath>
+#include <map>
+
+#define GLEW_STATIC 1
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+ImpostorCache::ImpostorCache(GLuint sceneShader, GLuint impostorShader, GLuint cubeVao)
+{
+	this->sceneShader = sceneShader;
+	this->impostorShader = impostorShader;
+	this->cubeVao = cubeVao;
+
+	this->angleThreshold = glm::radians(2.0f);
+	this->distanceThreshold = 0.05f;
+
+	this->captureCount = 0;
+
+	for (int i = 0; i < MAX_ENTRIES; i++) {
+		freeTiles[i] = true;
+	}
+
+	this->CreateAtlas();
+	this->CreateQuadVertexArrayObject();
+}
+
+ImpostorCache::~ImpostorCache()
+{
+	entries.clear();
+
+	glDeleteFramebuffers(1, &framebuffer);
+	glDeleteRenderbuffers(1, &depthRenderbuffer);
+	glDeleteTextures(1, &atlasTexture);
+	glDeleteVertexArrays(1, &quadVao);
+}
+
+void ImpostorCache::CreateAtlas()
+{
+	glGenTextures(1, &atlasTexture);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &depthRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, ATLAS_SIZE, ATLAS_SIZE);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlasTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+	isEnabled = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ImpostorCache::CreateQuadVertexArrayObject()
+{
+	// A unit quad in the XY plane facing +Z, wound clockwise to match glFrontFace(GL_CW)
+	float vertexArray[] = {
+		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+		 1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+		 1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+
+		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+		-1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
+		 1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
+	};
+
+	GLuint vertexArrayObject;
+	glGenVertexArrays(1, &vertexArrayObject);
+	glBindVertexArray(vertexArrayObject);
+
+	GLuint vertexBufferObject;
+	glGenBuffers(1, &vertexBufferObject);
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObject);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexArray), vertexArray, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0,
+		3,
+		GL_FLOAT,
+		GL_FALSE,
+		5 * sizeof(float),
+		(void*)0
+	);
+	glEnableVertexAttribArray(0);
+
+	glVertexAttribPointer(1,
+		2,
+		GL_FLOAT,
+		GL_FALSE,
+		5 * sizeof(float),
+		(void*)(3 * sizeof(float))
+	);
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	this->quadVao = vertexArrayObject;
+}
+
+void ImpostorCache::Draw(const RubikSnapshot& rubik, glm::vec3 cameraPosition, glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	// An animated Rubik's cube changes every frame, a camera inside the bounding sphere cannot be captured by a billboard and a
+	// Rubik's cube larger than a tile on screen would be blurred by one
+	float distance = glm::length(cameraPosition - rubik.center);
+	if (!isEnabled || rubik.isAnimated || distance <= rubik.boundingRadius || GetProjectedDiameter(rubik, distance, projectionMatrix) > TILE_SIZE) {
+		DrawCubes(rubik);
+		return;
+	}
+
+	std::map<const void*, Entry>::iterator it = entries.find(rubik.id);
+	if (it == entries.end()) {
+		int tile = -1;
+		for (int i = 0; i < MAX_ENTRIES; i++) {
+			if (freeTiles[i]) {
+				tile = i;
+				break;
+			}
+		}
+
+		// The atlas is full, fall back to drawing the Rubik's cube directly
+		if (tile < 0) {
+			DrawCubes(rubik);
+			return;
+		}
+
+		freeTiles[tile] = false;
+
+		Entry entry;
+		entry.tile = tile;
+		entry.isValid = false;
+		it = entries.insert(std::make_pair(rubik.id, entry)).first;
+	}
+
+	if (IsStale(it->second, rubik, cameraPosition)) {
+		Capture(it->second, rubik, cameraPosition, viewMatrix, projectionMatrix);
+	}
+
+	DrawBillboard(it->second, viewMatrix, projectionMatrix);
+}
+
+void ImpostorCache::Invalidate(const void* rubikId)
+{
+	std::map<const void*, Entry>::iterator it = entries.find(rubikId);
+	if (it != entries.end()) {
+		it->second.isValid = false;
+	}
+}
+
+void ImpostorCache::Release(const void* rubikId)
+{
+	std::map<const void*, Entry>::iterator it = entries.find(rubikId);
+	if (it != entries.end()) {
+		freeTiles[it->second.tile] = true;
+		entries.erase(it);
+	}
+}
+
+void ImpostorCache::SetAngleThreshold(float angleThreshold)
+{
+	this->angleThreshold = angleThreshold;
+}
+
+void ImpostorCache::SetDistanceThreshold(float distanceThreshold)
+{
+	this->distanceThreshold = distanceThreshold;
+}
+
+float ImpostorCache::GetProjectedDiameter(const RubikSnapshot& rubik, float distance, glm::mat4 projectionMatrix) const
+{
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// The bounding sphere spans 2 tan(halfAngle) in view space at unit depth, which the projection scales by 1 / tan(fovy / 2)
+	float halfAngle = asin(rubik.boundingRadius / distance);
+	return tan(halfAngle) * projectionMatrix[1][1] * viewport[3];
+}
+
+bool ImpostorCache::IsStale(const Entry& entry, const RubikSnapshot& rubik, glm::vec3 cameraPosition) const
+{
+	if (!entry.isValid || entry.revision != rubik.revision) {
+		return true;
+	}
+
+	// Angle of the rotation taking the captured orientation to the current one
+	glm::mat3 relativeRotation = glm::mat3(rubik.rotation) * glm::transpose(glm::mat3(entry.rotation));
+	float cosRotationAngle = glm::clamp((relativeRotation[0][0] + relativeRotation[1][1] + relativeRotation[2][2] - 1.0f) * 0.5f, -1.0f, 1.0f);
+	if (acos(cosRotationAngle) > angleThreshold) {
+		return true;
+	}
+
+	glm::vec3 toCamera = cameraPosition - rubik.center;
+	float distance = glm::length(toCamera);
+	if (fabs(distance - entry.viewDistance) > distanceThreshold * entry.viewDistance) {
+		return true;
+	}
+
+	float cosViewAngle = glm::clamp(glm::dot(toCamera / distance, entry.viewDirection), -1.0f, 1.0f);
+	return acos(cosViewAngle) > angleThreshold;
+}
+
+void ImpostorCache::Capture(Entry& entry, const RubikSnapshot& rubik, glm::vec3 cameraPosition, glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	glm::vec3 center = rubik.center;
+	float radius = rubik.boundingRadius;
+	glm::vec3 toCamera = cameraPosition - center;
+	float distance = glm::length(toCamera);
+
+	// Frame the bounding sphere tightly, looking from the scene camera with the same up vector so the billboard lines up with the scene
+	float halfAngle = asin(radius / distance);
+	glm::vec3 cameraUp = glm::vec3(glm::inverse(viewMatrix)[1]);
+	glm::mat4 captureViewMatrix = glm::lookAt(cameraPosition, center, cameraUp);
+	glm::mat4 captureProjectionMatrix = glm::perspective(2.0f * halfAngle, 1.0f, glm::max(distance - radius, 0.01f), distance + radius);
+
+	// The billboard lies in the plane going through the center of the Rubik's cube, facing the camera
+	float halfExtent = distance * tan(halfAngle);
+	glm::vec3 right = glm::vec3(captureViewMatrix[0][0], captureViewMatrix[1][0], captureViewMatrix[2][0]);
+	glm::vec3 up = glm::vec3(captureViewMatrix[0][1], captureViewMatrix[1][1], captureViewMatrix[2][1]);
+	glm::vec3 back = glm::vec3(captureViewMatrix[0][2], captureViewMatrix[1][2], captureViewMatrix[2][2]);
+	entry.billboardMatrix = glm::mat4(glm::vec4(right * halfExtent, 0.0f), glm::vec4(up * halfExtent, 0.0f), glm::vec4(back, 0.0f), glm::vec4(center, 1.0f));
+
+	// Render the Rubik's cube into its tile
+	GLint previousViewport[4];
+	GLfloat previousClearColor[4];
+	glGetIntegerv(GL_VIEWPORT, previousViewport);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+
+	int tileX = (entry.tile % TILES_PER_ROW) * TILE_SIZE;
+	int tileY = (entry.tile / TILES_PER_ROW) * TILE_SIZE;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glViewport(tileX, tileY, TILE_SIZE, TILE_SIZE);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(tileX, tileY, TILE_SIZE, TILE_SIZE);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+
+	SetUniformMat4(sceneShader, "viewMatrix", captureViewMatrix);
+	SetUniformMat4(sceneShader, "projectionMatrix", captureProjectionMatrix);
+	DrawCubes(rubik);
+
+	// Restore the state of the scene
+	SetUniformMat4(sceneShader, "viewMatrix", viewMatrix);
+	SetUniformMat4(sceneShader, "projectionMatrix", projectionMatrix);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+	glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+
+	entry.isValid = true;
+	entry.revision = rubik.revision;
+	entry.rotation = rubik.rotation;
+	entry.viewDirection = toCamera / distance;
+	entry.viewDistance = distance;
+
+	captureCount++;
+}
+
+void ImpostorCache::DrawCubes(const RubikSnapshot& rubik)
+{
+	for (size_t i = 0; i < rubik.cubes.size(); i++) {
+		Cube::DrawVertexArrayObject(sceneShader, cubeVao, rubik.cubes[i].worldMatrix, rubik.cubes[i].isSelected);
+	}
+}
+
+void ImpostorCache::DrawBillboard(const Entry& entry, glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+{
+	float tileScale = 1.0f / TILES_PER_ROW;
+	glm::vec4 tileRect = glm::vec4((entry.tile % TILES_PER_ROW) * tileScale, (entry.tile / TILES_PER_ROW) * tileScale, tileScale, tileScale);
+
+	SetUniformMat4(impostorShader, "worldMatrix", entry.billboardMatrix);
+	SetUniformMat4(impostorShader, "viewMatrix", viewMatrix);
+	SetUniformMat4(impostorShader, "projectionMatrix", projectionMatrix);
+	SetUniformVec4(impostorShader, "tileRect", tileRect);
+	SetUniform1Value(impostorShader, "impostorAtlas", 0);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+
+	glBindVertexArray(quadVao);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+	glBindVertexArray(0);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glUseProgram(sceneShader);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+	The main purpose of this class is to avoid redrawing Rubik's cubes that are sitting still. An idle Rubik's cube is rendered once
+	into a tile of a texture atlas, as seen from the current camera, and is then drawn as a single textured billboard until its
+	configuration, orientation or the camera changes beyond a threshold.
+
+	A Rubik's cube covering more than a tile on screen is drawn directly, since its billboard would be a magnified (blurred) capture,
+	and so is every Rubik's cube when the driver cannot render into the atlas.
+*/
+
+#pragma once
+
+#include "scenesnapshot.h"
+
+#include <map>
+
+#define GLEW_STATIC 1
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+class ImpostorCache {
+public:
+	static const int TILE_SIZE = 256; // Resolution (in pixels) of a single cached Rubik's cube
+	static const int TILES_PER_ROW = 8;
+	static const int ATLAS_SIZE = TILE_SIZE * TILES_PER_ROW;
+	static const int MAX_ENTRIES = TILES_PER_ROW * TILES_PER_ROW;
+
+	ImpostorCache(GLuint sceneShader, GLuint impostorShader, GLuint cubeVao);
+	virtual ~ImpostorCache();
+
+	// Draws the Rubik's cube, either as a cached billboard or directly when it is animated, larger than a tile or cannot be cached.
+	// viewMatrix and projectionMatrix are the matrices used for the current frame.
+	void Draw(const RubikSnapshot& rubik, glm::vec3 cameraPosition, glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
+
+	void Invalidate(const void* rubikId); // Forces the Rubik's cube to be captured again the next time it is drawn
+	void Release(const void* rubikId); // Frees the atlas tile used by the Rubik's cube
+
+	// Setters
+	void SetAngleThreshold(float angleThreshold);
+	void SetDistanceThreshold(float distanceThreshold);
+
+	// Getters
+	float GetAngleThreshold() const { return angleThreshold; }
+	float GetDistanceThreshold() const { return distanceThreshold; }
+
+	unsigned int GetCaptureCount() const { return captureCount; } // Number of times a Rubik's cube had to be rendered into the atlas
+	bool GetIsEnabled() const { return isEnabled; } // False when the atlas framebuffer is incomplete, every Rubik's cube is then drawn directly
+
+protected:
+	struct Entry {
+		int tile; // Index of the atlas tile holding the capture
+		bool isValid;
+		unsigned int revision; // Revision of the Rubik's cube when it was captured
+		glm::mat4 rotation; // Orientation of the Rubik's cube when it was captured
+		glm::vec3 viewDirection; // Normalized direction from the Rubik's cube to the camera when it was captured
+		float viewDistance;
+		glm::mat4 billboardMatrix; // World matrix placing the unit quad where the capture has to be drawn
+	};
+
+	GLuint sceneShader;
+	GLuint impostorShader;
+	GLuint cubeVao; // Geometry shared by all the cubes
+
+	GLuint framebuffer;
+	GLuint atlasTexture;
+	GLuint depthRenderbuffer;
+	GLuint quadVao;
+	bool isEnabled;
+
+	float angleThreshold; // Maximum change (in radians) of orientation or view direction before a capture is considered stale
+	float distanceThreshold; // Maximum relative change of the camera distance before a capture is considered stale
+
+	std::map<const void*, Entry> entries;
+	bool freeTiles[MAX_ENTRIES];
+
+	unsigned int captureCount;
+
+	float GetProjectedDiameter(const RubikSnapshot& rubik, float distance, glm::mat4 projectionMatrix) const; // In pixels of the viewport
+	bool IsStale(const Entry& entry, const RubikSnapshot& rubik, glm::vec3 cameraPosition) const;
+	void Capture(Entry& entry, const RubikSnapshot& rubik, glm::vec3 cameraPosition, glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
+	void DrawCubes(const RubikSnapshot& rubik);
+	void DrawBillboard(const Entry& entry, glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
+
+	void CreateAtlas();
+	void CreateQuadVertexArrayObject();
+};
\ No newline at end of file
@@ -19,6 +19,9 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
 
 #define GLEW_STATIC 1
 #include <GL/glew.h> 
@@ -29,9 +32,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "cubehistory.h"
+#include "cubemoves.h"
+#include "cubestate.h"
+#include "cubeverifier.h"
+#include "cubezobrist.h"
+#include "renderer.h"
 #include "rubik.h"
+#include "scenesnapshot.h"
 #include "utils.h"
 
+typedef Rubik<3> StandardRubik; // Other shapes (see rubik.cpp, e.g. Rubik<5> or the Rubik<3, 5, 3> cuboid) work as well, but only the 3x3x3 loads facelet strings
+
+// Everything the key callback works on, passed through the user pointer of the window
+struct InputContext {
+	StandardRubik* rubik;
+	CubeHistory<CubeState>* history; // Turns done with the keyboard, for undo and redo
+};
+
 // Referenced from COMP 371 course material
 int compileAndLinkShaders(std::string vertexFilePath, std::string fragmentFilePath)
 {
@@ -108,14 +126,16 @@ int compileAndLinkShaders(std::string vertexFilePath, std::string fragmentFilePa
 
 void detectKeyUserInput(GLFWwindow* window, int key, int scancode, int action, int mods) {
 	void* pointer = glfwGetWindowUserPointer(window);
-	Rubik* rubik = static_cast<Rubik *>(pointer);
+	InputContext* context = static_cast<InputContext *>(pointer);
+	StandardRubik* rubik = context->rubik;
+	CubeHistory<CubeState>* history = context->history;
 
 	if (!rubik->GetIsAnimated()) {
 		/****** CHANGE SELECTION SECTION *******/
 		if (key == GLFW_KEY_UP && action == GLFW_PRESS) {
 			int selectedSection = rubik->GetSelectedRubikSection();
 			selectedSection++;
-			if (selectedSection >= Rubik::NUMBER_OF_LAYERS) {
+			if (selectedSection >= StandardRubik::GetNumberOfSections(rubik->GetSelectedRubikSectionType())) {
 				selectedSection = 0;
 			}
 
@@ -125,7 +145,7 @@ void detectKeyUserInput(GLFWwindow* window, int key, int scancode, int action, i
 			int selectedSection = rubik->GetSelectedRubikSection();
 			selectedSection--;
 			if (selectedSection < 0) {
-				selectedSection = Rubik::NUMBER_OF_LAYERS - 1;
+				selectedSection = StandardRubik::GetNumberOfSections(rubik->GetSelectedRubikSectionType()) - 1;
 			}
 
 			rubik->SetSelectedRubikSection(selectedSection);
@@ -139,17 +159,121 @@ void detectKeyUserInput(GLFWwindow* window, int key, int scancode, int action, i
 		}
 		/****** ROTATE SELECTED SECTION (FOWARD) *******/
 		else if (key == GLFW_KEY_ENTER && action == GLFW_PRESS) {
+			history->Record(rubik->GetSelectedSliceTurn(true));
 			rubik->RotateRubikSelectedSection(true);
 		}
 		/****** ROTATE SELECTED SECTION (BACKWARD) *******/
 		else if (key == GLFW_KEY_BACKSPACE && action == GLFW_PRESS) {
+			history->Record(rubik->GetSelectedSliceTurn(false));
 			rubik->RotateRubikSelectedSection(false);
 		}
+		/****** UNDO AND REDO (WITH SHIFT, EVERY TURN AT ONCE) *******/
+		else if ((key == GLFW_KEY_Z || key == GLFW_KEY_Y) && action == GLFW_PRESS) {
+			std::vector<SliceTurn> turns;
+			do {
+				if (key == GLFW_KEY_Z && history->CanUndo()) {
+					turns.push_back(history->Undo());
+				}
+				else if (key == GLFW_KEY_Y && history->CanRedo()) {
+					turns.push_back(history->Redo());
+				}
+				else {
+					break;
+				}
+			} while (mods & GLFW_MOD_SHIFT);
+
+			rubik->ApplySliceTurns(turns.data(), static_cast<int>(turns.size()));
+		}
 	}
 }
 
+// Times random moves with and without Zobrist hashing (see CubeZobrist), without opening a window
+int runZobristBenchmark(int numberOfMoves)
+{
+	// Moves of each kind turn a different number of faces, which sets the cost of the incremental update
+	static const char* const KIND_NAMES[] = { "All moves", "Face turns", "Wide turns", "Slice turns", "Rotations" };
+	static const CubeMoves::Family FIRST_FAMILIES[] = { CubeMoves::U, CubeMoves::U, CubeMoves::UW, CubeMoves::M, CubeMoves::X };
+	static const CubeMoves::Family END_FAMILIES[] = { CubeMoves::NUMBER_OF_FAMILIES, CubeMoves::UW, CubeMoves::M, CubeMoves::X, CubeMoves::NUMBER_OF_FAMILIES };
+
+	std::cout << "ns per move: moves only, incremental hash (overhead), rehash after every move (overhead)" << std::endl;
+	for (int kind = 0; kind < 5; kind++) {
+		CubeZobrist::Benchmark benchmark = CubeZobrist::MeasureOverhead(numberOfMoves, FIRST_FAMILIES[kind], END_FAMILIES[kind]);
+		std::cout << KIND_NAMES[kind] << ": " << benchmark.plainNanoseconds
+			<< ", " << benchmark.incrementalNanoseconds << " (+" << benchmark.incrementalNanoseconds - benchmark.plainNanoseconds << ")"
+			<< ", " << benchmark.fullNanoseconds << " (+" << benchmark.fullNanoseconds - benchmark.plainNanoseconds << ")" << std::endl;
+	}
+
+	return 0;
+}
+
+// Runs one engine of the verifier and prints its report, returns the number of mismatching cases
+uint64_t runVerifier(CubeVerifier::Engine engine, MoveEngine::InstructionSet instructionSet, int size, uint64_t seed, uint64_t numberOfCases, int movesPerCase)
+{
+	CubeVerifier verifier(engine, instructionSet, seed);
+	verifier.SetSize(size);
+	CubeVerifier::Report report = verifier.Run(numberOfCases, movesPerCase);
+
+	std::cout << CubeVerifier::GetEngineName(engine);
+	if (CubeVerifier::GetHasInstructionSets(engine)) {
+		std::cout << " " << MoveEngine::GetInstructionSetName(verifier.GetInstructionSet());
+	}
+	if (CubeVerifier::GetIsSurfaceEngine(engine)) {
+		std::cout << " " << size << "x" << size << "x" << size << (size > CubeVerifier::MAXIMUM_RUBIK_SIZE ? " (surfaces only)" : "");
+	}
+	std::cout << ": " << report.numberOfCases << " cases, " << report.numberOfMoves << " moves, " << report.numberOfMismatches
+		<< " mismatches, " << static_cast<uint64_t>(report.movesPerSecond) << " moves/s" << std::endl;
+
+	for (size_t i = 0; i < report.counterexamples.size(); i++) {
+		const CubeVerifier::Counterexample& counterexample = report.counterexamples[i];
+		std::cout << "  case " << counterexample.caseIndex << ": " << CubeVerifier::FormatMoves(counterexample) << std::endl;
+		std::cout << "    expected " << counterexample.expectedFacelets << std::endl;
+		std::cout << "    actual   " << counterexample.actualFacelets << std::endl;
+	}
+
+	return report.numberOfMismatches;
+}
+
+int runVerifiers(uint64_t seed, uint64_t numberOfCases, int movesPerCase)
+{
+	static const int SURFACE_SIZES[] = { 2, 3, 4, 5, 6, 7, 8, 9, 10, 40, 100 };
+
+	std::cout << "Seed " << seed << std::endl;
+
+	// Every kernel the CPU can run is checked, not only the one the engines would pick
+	MoveEngine::InstructionSet bestInstructionSet = MoveEngine::DetectInstructionSet();
+
+	uint64_t numberOfMismatches = 0;
+	for (int i = 0; i < CubeVerifier::NUMBER_OF_ENGINES; i++) {
+		CubeVerifier::Engine engine = static_cast<CubeVerifier::Engine>(i);
+
+		if (CubeVerifier::GetIsSurfaceEngine(engine)) {
+			for (size_t j = 0; j < sizeof(SURFACE_SIZES) / sizeof(SURFACE_SIZES[0]); j++) {
+				numberOfMismatches += runVerifier(engine, bestInstructionSet, SURFACE_SIZES[j], seed, numberOfCases, movesPerCase);
+			}
+		}
+		else if (CubeVerifier::GetHasInstructionSets(engine)) {
+			for (int instructionSet = MoveEngine::SCALAR; instructionSet <= bestInstructionSet; instructionSet++) {
+				numberOfMismatches += runVerifier(engine, static_cast<MoveEngine::InstructionSet>(instructionSet), 3, seed, numberOfCases, movesPerCase);
+			}
+		}
+		else {
+			numberOfMismatches += runVerifier(engine, bestInstructionSet, 3, seed, numberOfCases, movesPerCase);
+		}
+	}
+
+	return numberOfMismatches == 0 ? 0 : 1;
+}
+
 int main(int argc, char*argv[])
 {
+	// Headless tools: --benchmark-zobrist [moves], --verify [seed] [cases] [moves]
+	if (argc > 1 && std::string(argv[1]) == "--benchmark-zobrist") {
+		return runZobristBenchmark(argc > 2 ? atoi(argv[2]) : 10000000);
+	}
+	if (argc > 1 && std::string(argv[1]) == "--verify") {
+		return runVerifiers(argc > 2 ? strtoull(argv[2], NULL, 10) : 1, argc > 3 ? strtoull(argv[3], NULL, 10) : 100, argc > 4 ? atoi(argv[4]) : 100);
+	}
+
 	// Initialize GLFW and OpenGL version
 	glfwInit();
 
@@ -190,6 +314,7 @@ int main(int argc, char*argv[])
 
 	// Compile and link shaders
 	int shaderProgram = compileAndLinkShaders("../Source/VertexShader.glsl", "../Source/FragmentShader.glsl");
+	int impostorShaderProgram = compileAndLinkShaders("../Source/ImpostorVertexShader.glsl", "../Source/ImpostorFragmentShader.glsl");
 
 	// Don't use highlight color by default
 	SetUniform1Value(shaderProgram, "useHighlightColor", false);
@@ -211,14 +336,38 @@ int main(int argc, char*argv[])
 		glm::vec3(0.0f, 1.0f, 0.0f));
 
 	/********* SET UP SCENE OBJECTS *********/
-	Rubik *rubik = new Rubik(glm::vec3(0.0f, 2.0f, 0.0f), shaderProgram);
+	StandardRubik *rubik = new StandardRubik(glm::vec3(0.0f, 2.0f, 0.0f), shaderProgram);
+
+	// An optional facelet string (e.g. UUFUUFUUFRRRRRRRRRFFDFFDFFDDDBDDBDDBLLLLLLLLLUBBUBBUBB) sets the starting configuration
+	if (argc > 1) {
+		CubeFacelets::Error error = rubik->SetFacelets(argv[1]);
+		if (error != CubeFacelets::FACELETS_VALID) {
+			std::cerr << "Invalid facelets: " << CubeFacelets::GetErrorMessage(error) << std::endl;
+		}
+	}
+
+	// Turns are undone with Z and redone with Y, one at a time or all of them with Shift
+	CubeHistory<CubeState> *history = new CubeHistory<CubeState>(rubik->GetCubeState(), 64);
 
 	/*********** SET UP KEY INPUT DETECTION ************/
-	glfwSetWindowUserPointer(window, rubik);
+	InputContext inputContext;
+	inputContext.rubik = rubik;
+	inputContext.history = history;
+	glfwSetWindowUserPointer(window, &inputContext);
 	glfwSetKeyCallback(window, detectKeyUserInput);
 
+	/*********** HAND THE CONTEXT OVER TO THE RENDER THREAD ************/
+	// From here on, the main thread only handles input and simulation. Everything the renderer needs is published as a SceneSnapshot.
+	glfwMakeContextCurrent(NULL);
+	Renderer *renderer = new Renderer(window, shaderProgram, impostorShaderProgram);
+	renderer->Start();
+
 	/*********** SET UP FRAME TIME TRACKING ************/
+	// The simulation runs at a fixed rate, independently of how fast the renderer presents frames
+	const std::chrono::microseconds SIMULATION_STEP(16667);
+	std::chrono::steady_clock::time_point nextStepTime = std::chrono::steady_clock::now();
 	float lastFrameTime = glfwGetTime();
+	unsigned int simulationStep = 0;
 
 	// Main Loop
 	while (!glfwWindowShouldClose(window))
@@ -227,27 +376,8 @@ int main(int argc, char*argv[])
 		float dt = glfwGetTime() - lastFrameTime;
 		lastFrameTime += dt;
 
-		/******** SCENE RENDERING ********/
-		glUseProgram(shaderProgram);
-
-		// Set view position on scene shader
-		SetUniformVec3(shaderProgram, "view_position", cameraPosition);
-
-		// Use proper image output size
-		int width, height;
-		glfwGetFramebufferSize(window, &width, &height);
-		glViewport(0, 0, width, height);
-
-		// Bind screen as output framebuffer
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		
-		rubik->SetShader(shaderProgram);
-		rubik->Draw();
-
-		// Adjusting perspective
-		glm::mat4 projectionMatrix = glm::perspective(glm::radians(45.0f), 1024.0f / 768.0f, 0.01f, 100.0f);
-		SetUniformMat4(shaderProgram, "projectionMatrix", projectionMatrix);
+		// Key input is dispatched to detectKeyUserInput from here
+		glfwPollEvents();
 
 		/*************************
 		MOUSE BUTTONS USER INPUT
@@ -278,21 +408,48 @@ int main(int argc, char*argv[])
 			rubik->SetRotation(newRotation);
 		}
 
+		/******** SIMULATION ********/
+		rubik->Update();
+
+		/******** PUBLISH THE SCENE SNAPSHOT TO THE RENDERER ********/
+		SceneSnapshot& snapshot = renderer->BeginSnapshot();
+		snapshot.step = simulationStep++;
+
+		// Use proper image output size
+		glfwGetFramebufferSize(window, &snapshot.framebufferWidth, &snapshot.framebufferHeight);
+
+		// Adjusting perspective
+		snapshot.projectionMatrix = glm::perspective(glm::radians(45.0f), 1024.0f / 768.0f, 0.01f, 100.0f);
+
 		/****** ADJUSTING CAMERA POSITION *******/
 		viewMatrix = glm::lookAt(cameraPosition, // eye
 			cameraCenter, // center
 			glm::vec3(0.0f, 1.0f, 0.0f));
-		SetUniformMat4(shaderProgram, "viewMatrix", viewMatrix);
+		snapshot.viewMatrix = viewMatrix;
+		snapshot.cameraPosition = cameraPosition;
+
+		snapshot.rubiks.resize(1);
+		rubik->FillSnapshot(snapshot.rubiks[0]);
+
+		renderer->PublishSnapshot();
 
 		/****** DETECT EXIT *******/
 		if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 			glfwSetWindowShouldClose(window, true);
 
 		// End Frame
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+		nextStepTime += SIMULATION_STEP;
+		if (nextStepTime < std::chrono::steady_clock::now()) {
+			// The step took too long (e.g. the window was being dragged), do not try to catch up
+			nextStepTime = std::chrono::steady_clock::now();
+		}
+		std::this_thread::sleep_until(nextStepTime);
 	}
 
+	// The render thread has to release the context before the window is destroyed
+	renderer->Stop();
+	delete renderer;
+
 	// Shutdown GLFW
 	glfwTerminate();
 
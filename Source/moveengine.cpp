@@ -0,0 +1,329 @@
+#include "moveengine.h"
+#include "cubealgorithm.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+#include "simd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+// Subtracting the modulus from an orientation byte that is out of range gives a smaller value, and wraps around to a larger one
+// otherwise, so min(value, value - modulus) brings orientations back in range without branches. Unused bytes and the frame are left alone.
+alignas(32) static const uint8_t ORIENTATION_MODULI[CubeState::STATE_SIZE] = {
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+	0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30
+};
+
+struct MoveEngineKernels {
+	static void ApplyScalar(const MoveEngine::FacePairTurn& turn, uint8_t* bytes)
+	{
+		uint8_t result[CubeState::STATE_SIZE];
+		for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+			uint8_t value = bytes[(i & 16) + turn.shuffle[i]] + turn.twist[i];
+			uint8_t reduced = value - ORIENTATION_MODULI[i];
+			result[i] = reduced < value ? reduced : value;
+		}
+
+		memcpy(bytes, result, CubeState::STATE_SIZE);
+	}
+
+	static void SequenceScalar(const MoveEngine& engine, CubeState& state, const uint8_t* moves, size_t numberOfMoves)
+	{
+		int frame = state.GetFrame();
+		for (size_t i = 0; i < numberOfMoves; i++) {
+			MoveEngine::Transition transition = engine.transitions[frame][moves[i]];
+			ApplyScalar(engine.facePairTurns[transition.facePairTurn], state.bytes);
+			frame = transition.frame;
+		}
+
+		state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+	}
+
+	static void BatchScalar(const MoveEngine& engine, CubeState* states, size_t numberOfStates, int move)
+	{
+		for (size_t i = 0; i < numberOfStates; i++) {
+			MoveEngine::Transition transition = engine.transitions[states[i].GetFrame()][move];
+			ApplyScalar(engine.facePairTurns[transition.facePairTurn], states[i].bytes);
+			states[i].bytes[CubeState::FRAME_OFFSET] = transition.frame;
+		}
+	}
+
+	static void PermuteScalar(const MoveEngine::FacePairTurn* permutations, const uint8_t* frames, CubeState* states, size_t numberOfStates)
+	{
+		for (size_t i = 0; i < numberOfStates; i++) {
+			int frame = states[i].GetFrame();
+			ApplyScalar(permutations[frame], states[i].bytes);
+			states[i].bytes[CubeState::FRAME_OFFSET] = frames[frame];
+		}
+	}
+
+#if defined(SIMD_X86)
+	TARGET_SSSE3 static void ApplySsse3(const MoveEngine::FacePairTurn& turn, __m128i& edges, __m128i& corners)
+	{
+		const __m128i edgeModuli = _mm_load_si128(reinterpret_cast<const __m128i*>(ORIENTATION_MODULI));
+		const __m128i cornerModuli = _mm_load_si128(reinterpret_cast<const __m128i*>(ORIENTATION_MODULI + 16));
+
+		edges = _mm_shuffle_epi8(edges, _mm_load_si128(reinterpret_cast<const __m128i*>(turn.shuffle)));
+		corners = _mm_shuffle_epi8(corners, _mm_load_si128(reinterpret_cast<const __m128i*>(turn.shuffle + 16)));
+
+		edges = _mm_add_epi8(edges, _mm_load_si128(reinterpret_cast<const __m128i*>(turn.twist)));
+		corners = _mm_add_epi8(corners, _mm_load_si128(reinterpret_cast<const __m128i*>(turn.twist + 16)));
+
+		edges = _mm_min_epu8(edges, _mm_sub_epi8(edges, edgeModuli));
+		corners = _mm_min_epu8(corners, _mm_sub_epi8(corners, cornerModuli));
+	}
+
+	TARGET_SSSE3 static void SequenceSsse3(const MoveEngine& engine, CubeState& state, const uint8_t* moves, size_t numberOfMoves)
+	{
+		__m128i edges = _mm_load_si128(reinterpret_cast<const __m128i*>(state.bytes));
+		__m128i corners = _mm_load_si128(reinterpret_cast<const __m128i*>(state.bytes + 16));
+
+		int frame = state.GetFrame();
+		for (size_t i = 0; i < numberOfMoves; i++) {
+			MoveEngine::Transition transition = engine.transitions[frame][moves[i]];
+			ApplySsse3(engine.facePairTurns[transition.facePairTurn], edges, corners);
+			frame = transition.frame;
+		}
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(state.bytes), edges);
+		_mm_store_si128(reinterpret_cast<__m128i*>(state.bytes + 16), corners);
+		state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+	}
+
+	TARGET_SSSE3 static void BatchSsse3(const MoveEngine& engine, CubeState* states, size_t numberOfStates, int move)
+	{
+		for (size_t i = 0; i < numberOfStates; i++) {
+			MoveEngine::Transition transition = engine.transitions[states[i].GetFrame()][move];
+
+			__m128i edges = _mm_load_si128(reinterpret_cast<const __m128i*>(states[i].bytes));
+			__m128i corners = _mm_load_si128(reinterpret_cast<const __m128i*>(states[i].bytes + 16));
+			ApplySsse3(engine.facePairTurns[transition.facePairTurn], edges, corners);
+			_mm_store_si128(reinterpret_cast<__m128i*>(states[i].bytes), edges);
+			_mm_store_si128(reinterpret_cast<__m128i*>(states[i].bytes + 16), corners);
+
+			states[i].bytes[CubeState::FRAME_OFFSET] = transition.frame;
+		}
+	}
+
+	TARGET_SSSE3 static void PermuteSsse3(const MoveEngine::FacePairTurn* permutations, const uint8_t* frames, CubeState* states, size_t numberOfStates)
+	{
+		for (size_t i = 0; i < numberOfStates; i++) {
+			int frame = states[i].GetFrame();
+
+			__m128i edges = _mm_load_si128(reinterpret_cast<const __m128i*>(states[i].bytes));
+			__m128i corners = _mm_load_si128(reinterpret_cast<const __m128i*>(states[i].bytes + 16));
+			ApplySsse3(permutations[frame], edges, corners);
+			_mm_store_si128(reinterpret_cast<__m128i*>(states[i].bytes), edges);
+			_mm_store_si128(reinterpret_cast<__m128i*>(states[i].bytes + 16), corners);
+
+			states[i].bytes[CubeState::FRAME_OFFSET] = frames[frame];
+		}
+	}
+
+	TARGET_AVX2 static __m256i ApplyAvx2(const MoveEngine::FacePairTurn& turn, __m256i state)
+	{
+		// The 256 bit byte shuffle works within each 128 bit lane, which is exactly the edge/corner split of the packed layout
+		const __m256i moduli = _mm256_load_si256(reinterpret_cast<const __m256i*>(ORIENTATION_MODULI));
+
+		state = _mm256_shuffle_epi8(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(turn.shuffle)));
+		state = _mm256_add_epi8(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(turn.twist)));
+		return _mm256_min_epu8(state, _mm256_sub_epi8(state, moduli));
+	}
+
+	TARGET_AVX2 static void SequenceAvx2(const MoveEngine& engine, CubeState& state, const uint8_t* moves, size_t numberOfMoves)
+	{
+		__m256i vector = _mm256_load_si256(reinterpret_cast<const __m256i*>(state.bytes));
+
+		int frame = state.GetFrame();
+		for (size_t i = 0; i < numberOfMoves; i++) {
+			MoveEngine::Transition transition = engine.transitions[frame][moves[i]];
+			vector = ApplyAvx2(engine.facePairTurns[transition.facePairTurn], vector);
+			frame = transition.frame;
+		}
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(state.bytes), vector);
+		state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(frame);
+	}
+
+	TARGET_AVX2 static void BatchAvx2(const MoveEngine& engine, CubeState* states, size_t numberOfStates, int move)
+	{
+		for (size_t i = 0; i < numberOfStates; i++) {
+			MoveEngine::Transition transition = engine.transitions[states[i].GetFrame()][move];
+
+			__m256i vector = _mm256_load_si256(reinterpret_cast<const __m256i*>(states[i].bytes));
+			vector = ApplyAvx2(engine.facePairTurns[transition.facePairTurn], vector);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(states[i].bytes), vector);
+
+			states[i].bytes[CubeState::FRAME_OFFSET] = transition.frame;
+		}
+	}
+
+	TARGET_AVX2 static void PermuteAvx2(const MoveEngine::FacePairTurn* permutations, const uint8_t* frames, CubeState* states, size_t numberOfStates)
+	{
+		for (size_t i = 0; i < numberOfStates; i++) {
+			int frame = states[i].GetFrame();
+
+			__m256i vector = _mm256_load_si256(reinterpret_cast<const __m256i*>(states[i].bytes));
+			vector = ApplyAvx2(permutations[frame], vector);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(states[i].bytes), vector);
+
+			states[i].bytes[CubeState::FRAME_OFFSET] = frames[frame];
+		}
+	}
+#endif
+};
+
+MoveEngine::MoveEngine()
+{
+	Initialize(DetectInstructionSet());
+}
+
+MoveEngine::MoveEngine(InstructionSet instructionSet)
+{
+	InstructionSet supportedInstructionSet = DetectInstructionSet();
+	Initialize(instructionSet < supportedInstructionSet ? instructionSet : supportedInstructionSet);
+}
+
+MoveEngine::~MoveEngine()
+{
+}
+
+void MoveEngine::Initialize(InstructionSet instructionSet)
+{
+	this->instructionSet = instructionSet;
+
+	sequenceKernel = MoveEngineKernels::SequenceScalar;
+	batchKernel = MoveEngineKernels::BatchScalar;
+	permutationKernel = MoveEngineKernels::PermuteScalar;
+#if defined(SIMD_X86)
+	if (instructionSet == SSSE3) {
+		sequenceKernel = MoveEngineKernels::SequenceSsse3;
+		batchKernel = MoveEngineKernels::BatchSsse3;
+		permutationKernel = MoveEngineKernels::PermuteSsse3;
+	}
+	else if (instructionSet == AVX2) {
+		sequenceKernel = MoveEngineKernels::SequenceAvx2;
+		batchKernel = MoveEngineKernels::BatchAvx2;
+		permutationKernel = MoveEngineKernels::PermuteAvx2;
+	}
+#endif
+
+	CreateTables();
+}
+
+void MoveEngine::CreateTables()
+{
+	// Turns of a pair of opposite faces, read back from a solved cube: slot i then holds the piece that has to move into it
+	for (int axis = 0; axis < NUMBER_OF_AXES; axis++) {
+		CubeFace positiveFace = CubeRotation::GetPositiveFace(static_cast<CubeAxis>(axis));
+
+		for (int positiveQuarterTurns = 0; positiveQuarterTurns < 4; positiveQuarterTurns++) {
+			for (int negativeQuarterTurns = 0; negativeQuarterTurns < 4; negativeQuarterTurns++) {
+				CubeState state;
+				state.ApplyFaceTurn(positiveFace, positiveQuarterTurns);
+				state.ApplyFaceTurn(CubeRotation::GetOppositeFace(positiveFace), negativeQuarterTurns);
+
+				FacePairTurn& turn = facePairTurns[axis * 16 + positiveQuarterTurns * 4 + negativeQuarterTurns];
+				for (int i = 0; i < CubeState::STATE_SIZE; i++) {
+					bool isEdge = i >= CubeState::EDGE_OFFSET && i < CubeState::EDGE_OFFSET + CubeState::NUMBER_OF_EDGES;
+					bool isCorner = i >= CubeState::CORNER_OFFSET && i < CubeState::CORNER_OFFSET + CubeState::NUMBER_OF_CORNERS;
+
+					if (isEdge || isCorner) {
+						turn.shuffle[i] = state.bytes[i] & CubeState::PIECE_MASK;
+						turn.twist[i] = state.bytes[i] & ~CubeState::PIECE_MASK;
+					}
+					else {
+						turn.shuffle[i] = i & 15;
+						turn.twist[i] = 0;
+					}
+				}
+			}
+		}
+	}
+
+	// Each move, seen from each frame
+	for (int frame = 0; frame < CubeRotation::NUMBER_OF_ROTATIONS; frame++) {
+		for (int move = 0; move < CubeMoves::NUMBER_OF_MOVES; move++) {
+			CubeFace face;
+			int faceQuarterTurns, oppositeFaceQuarterTurns;
+			int newFrame = CubeState::ResolveLayerTurns(CubeMoves::GetLayerTurns(move), frame, face, faceQuarterTurns, oppositeFaceQuarterTurns);
+
+			if (!CubeRotation::IsPositiveFace(face)) {
+				std::swap(faceQuarterTurns, oppositeFaceQuarterTurns);
+			}
+
+			transitions[frame][move].facePairTurn = static_cast<uint8_t>(CubeRotation::GetFaceAxis(face) * 16 + faceQuarterTurns * 4 + oppositeFaceQuarterTurns);
+			transitions[frame][move].frame = static_cast<uint8_t>(newFrame);
+		}
+	}
+}
+
+void MoveEngine::Apply(CubeState& state, int move) const
+{
+	uint8_t moves[1] = { static_cast<uint8_t>(move) };
+	sequenceKernel(*this, state, moves, 1);
+}
+
+void MoveEngine::Apply(CubeState& state, const uint8_t* moves, size_t numberOfMoves) const
+{
+	sequenceKernel(*this, state, moves, numberOfMoves);
+}
+
+void MoveEngine::Apply(CubeState* states, size_t numberOfStates, int move) const
+{
+	batchKernel(*this, states, numberOfStates, move);
+}
+
+void MoveEngine::Apply(CubeState* states, size_t numberOfStates, const CubeAlgorithm& algorithm) const
+{
+	permutationKernel(algorithm.GetPermutations(), algorithm.GetFinalFrames(), states, numberOfStates);
+}
+
+MoveEngine::InstructionSet MoveEngine::DetectInstructionSet()
+{
+#if defined(SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	int highestFunction = info[0];
+
+	__cpuid(info, 1);
+	bool hasSsse3 = (info[2] & (1 << 9)) != 0;
+	bool hasOsAvxSupport = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+
+	bool hasAvx2 = false;
+	if (highestFunction >= 7 && hasOsAvxSupport) {
+		__cpuidex(info, 7, 0);
+		hasAvx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	bool hasSsse3 = __builtin_cpu_supports("ssse3");
+	bool hasAvx2 = __builtin_cpu_supports("avx2");
+#endif
+
+	if (hasAvx2) {
+		return AVX2;
+	}
+	if (hasSsse3) {
+		return SSSE3;
+	}
+#endif
+
+	return SCALAR;
+}
+
+const char* MoveEngine::GetInstructionSetName(InstructionSet instructionSet)
+{
+	if (instructionSet == AVX2) {
+		return "AVX2";
+	}
+	else if (instructionSet == SSSE3) {
+		return "SSSE3";
+	}
+
+	return "scalar";
+}
\ No newline at end of file
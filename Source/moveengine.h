@@ -0,0 +1,71 @@
+/*
+	The main purpose of this class is to apply moves to CubeStates as fast as possible, for batch analysis jobs.
+
+	Any move of the standard notation (face, wide, slice or rotation, see CubeMoves) comes down to clockwise turns of two opposite
+	faces plus a change of frame. The 48 possible pairs of opposite face turns are precomputed in the packed CubeState layout, so a
+	move is one table lookup, one byte shuffle of the 32 byte state and a vector add/min to bring the orientations back in range.
+	The best available instruction set (AVX2, SSSE3 or plain scalar code) is picked at run time.
+*/
+
+#pragma once
+
+#include "cubestate.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class CubeAlgorithm;
+
+class MoveEngine {
+public:
+	enum InstructionSet { SCALAR, SSSE3, AVX2 };
+
+	MoveEngine(); // Uses the best instruction set supported by the CPU
+	MoveEngine(InstructionSet instructionSet); // Uses the given instruction set, or the best supported one below it
+	virtual ~MoveEngine();
+
+	void Apply(CubeState& state, int move) const;
+	void Apply(CubeState& state, const uint8_t* moves, size_t numberOfMoves) const; // Applies a sequence of moves, keeping the state in registers
+	void Apply(CubeState* states, size_t numberOfStates, int move) const; // Applies the same move to many states
+	void Apply(CubeState* states, size_t numberOfStates, const CubeAlgorithm& algorithm) const; // Applies a compiled algorithm to many states
+
+	// Getters
+	InstructionSet GetInstructionSet() const { return instructionSet; }
+
+	static InstructionSet DetectInstructionSet();
+	static const char* GetInstructionSetName(InstructionSet instructionSet);
+
+	static const int NUMBER_OF_FACE_PAIR_TURNS = NUMBER_OF_AXES * 4 * 4;
+
+	// Shuffle and orientation tables for turning the positive face of an axis (R, U or F) i times and the opposite face j times,
+	// at index axis * 16 + i * 4 + j. Shuffle indices are relative to each 16 byte half, as expected by the byte shuffle instructions.
+	struct FacePairTurn {
+		alignas(32) uint8_t shuffle[CubeState::STATE_SIZE];
+		alignas(32) uint8_t twist[CubeState::STATE_SIZE];
+	};
+
+	// Effect of a move on a cube in a given frame
+	struct Transition {
+		uint8_t facePairTurn;
+		uint8_t frame;
+	};
+
+protected:
+	typedef void (*SequenceKernel)(const MoveEngine& engine, CubeState& state, const uint8_t* moves, size_t numberOfMoves);
+	typedef void (*BatchKernel)(const MoveEngine& engine, CubeState* states, size_t numberOfStates, int move);
+	typedef void (*PermutationKernel)(const FacePairTurn* permutations, const uint8_t* frames, CubeState* states, size_t numberOfStates); // Permutation and new frame picked by the frame of each state
+
+	InstructionSet instructionSet;
+	SequenceKernel sequenceKernel;
+	BatchKernel batchKernel;
+	PermutationKernel permutationKernel;
+
+	FacePairTurn facePairTurns[NUMBER_OF_FACE_PAIR_TURNS];
+	Transition transitions[CubeRotation::NUMBER_OF_ROTATIONS][CubeMoves::NUMBER_OF_MOVES];
+
+	void Initialize(InstructionSet instructionSet);
+	void CreateTables();
+
+	// The kernels are defined in moveengine.cpp, each compiled for its own instruction set
+	friend struct MoveEngineKernels;
+};
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "persistentsurface.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubesurface.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const char FACE_NAMES[NUMBER_OF_FACES + 1] = "URFDLB";
+
+PersistentSurface::PersistentSurface(int size)
+{
+	this->size = size;
+	tilesPerLine = (size + TILE_SIZE - 1) / TILE_SIZE;
+	frame = CubeRotation::IDENTITY;
+
+	// Every tile of a solved face looks the same, so they are all one
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		std::shared_ptr<const Tile> tile = std::make_shared<const Tile>(static_cast<size_t>(TILE_SIZE) * TILE_SIZE, static_cast<uint8_t>(face));
+		faces[face] = std::make_shared<const Face>(static_cast<size_t>(tilesPerLine) * tilesPerLine, tile);
+		faceTurns[face] = 0;
+	}
+}
+
+PersistentSurface::~PersistentSurface()
+{
+}
+
+void PersistentSurface::ApplySliceTurn(CubeAxis axis, int slice, int quarterTurns)
+{
+	SliceTurn ownTurn = CubeSurface::GetOwnSliceTurn(size, frame, axis, slice, quarterTurns);
+	axis = ownTurn.axis;
+	slice = ownTurn.slice;
+	quarterTurns = ownTurn.quarterTurns;
+	if (quarterTurns == 0) {
+		return;
+	}
+
+	CubeFace ringFaces[4];
+	int rows[4][2], columns[4][2];
+	CubeSurface::GetRing(size, axis, slice, ringFaces, rows, columns);
+
+	// Along the ring every face is read on a straight line of its array
+	int startRows[4], startColumns[4], rowSteps[4], columnSteps[4];
+	for (int i = 0; i < 4; i++) {
+		int endRow, endColumn;
+		CubeSurface::GetStoredRowAndColumn(size, faceTurns[ringFaces[i]], rows[i][0], columns[i][0], startRows[i], startColumns[i]);
+		CubeSurface::GetStoredRowAndColumn(size, faceTurns[ringFaces[i]], rows[i][1], columns[i][1], endRow, endColumn);
+		rowSteps[i] = endRow - startRows[i];
+		columnSteps[i] = endColumn - startColumns[i];
+	}
+
+	// The old faces stay alive until the turn is over, so each line is copied straight from their tiles into the new ones. Lines are
+	// walked one run at a time, a run staying in the same tile on both sides.
+	std::shared_ptr<const Face> oldFaces[4];
+	for (int i = 0; i < 4; i++) {
+		oldFaces[i] = faces[ringFaces[i]];
+	}
+
+	// Each face gets a new array of tile pointers, where only the tiles crossed by the line are new
+	for (int i = 0; i < 4; i++) {
+		int destination = (i + quarterTurns) & 3;
+		const Face& source = *oldFaces[i];
+		std::shared_ptr<Face> face = std::make_shared<Face>(*oldFaces[destination]);
+
+		std::shared_ptr<Tile> tile;
+		size_t tileIndex = 0;
+		for (int k = 0; k < size;) {
+			int row = startRows[i] + k * rowSteps[i];
+			int column = startColumns[i] + k * columnSteps[i];
+			int destinationRow = startRows[destination] + k * rowSteps[destination];
+			int destinationColumn = startColumns[destination] + k * columnSteps[destination];
+			int count = GetTileRun(row, column, rowSteps[i], columnSteps[i], size - k);
+			count = GetTileRun(destinationRow, destinationColumn, rowSteps[destination], columnSteps[destination], count);
+
+			// A line leaves a tile for good, so a new tile is only made the first time it is reached
+			size_t destinationTileIndex = GetTileIndex(destinationRow, destinationColumn);
+			if (!tile || destinationTileIndex != tileIndex) {
+				tileIndex = destinationTileIndex;
+				tile = std::make_shared<Tile>(*(*face)[tileIndex]);
+				(*face)[tileIndex] = tile;
+			}
+
+			const uint8_t* stickers = source[GetTileIndex(row, column)]->data() + (row % TILE_SIZE) * TILE_SIZE + column % TILE_SIZE;
+			uint8_t* destinationStickers = tile->data() + (destinationRow % TILE_SIZE) * TILE_SIZE + destinationColumn % TILE_SIZE;
+			ptrdiff_t step = rowSteps[i] * TILE_SIZE + columnSteps[i];
+			ptrdiff_t destinationStep = rowSteps[destination] * TILE_SIZE + columnSteps[destination];
+			for (int j = 0; j < count; j++) {
+				destinationStickers[j * destinationStep] = stickers[j * step];
+			}
+
+			k += count;
+		}
+
+		faces[ringFaces[destination]] = face;
+	}
+
+	// An outer slice also turns its face
+	for (int side = 0; side < 2; side++) {
+		CubeFace face = side == 0 ? CubeRotation::GetOppositeFace(CubeRotation::GetPositiveFace(axis)) : CubeRotation::GetPositiveFace(axis);
+		if (slice == (side == 0 ? 0 : size - 1)) {
+			faceTurns[face] = static_cast<uint8_t>((faceTurns[face] + CubeSurface::GetFaceQuarterTurns(size, face, axis, quarterTurns)) & 3);
+		}
+	}
+}
+
+void PersistentSurface::ApplyFaceTurn(CubeFace face, int quarterTurns)
+{
+	// Clockwise seen from outside is counterclockwise around the axis for the face on the negative side, and clockwise for the positive one
+	CubeAxis axis = CubeRotation::GetFaceAxis(face);
+	if (CubeRotation::IsPositiveFace(face)) {
+		ApplySliceTurn(axis, size - 1, -quarterTurns);
+	}
+	else {
+		ApplySliceTurn(axis, 0, quarterTurns);
+	}
+}
+
+void PersistentSurface::ApplyRotation(CubeAxis axis, int quarterTurns)
+{
+	frame = static_cast<uint8_t>(CubeRotation::Compose(CubeRotation::FromAxis(axis, quarterTurns), frame));
+}
+
+bool PersistentSurface::IsSolved() const
+{
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		uint8_t color = GetStoredSticker(static_cast<CubeFace>(face), 0, 0);
+		for (int row = 0; row < size; row++) {
+			for (int column = 0; column < size; column++) {
+				if (GetStoredSticker(static_cast<CubeFace>(face), row, column) != color) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void PersistentSurface::Format(char* facelets) const
+{
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		for (int row = 0; row < size; row++) {
+			for (int column = 0; column < size; column++) {
+				*facelets++ = FACE_NAMES[GetSticker(static_cast<CubeFace>(face), row, column)];
+			}
+		}
+	}
+}
+
+std::string PersistentSurface::Format() const
+{
+	std::string facelets(NUMBER_OF_FACES * static_cast<size_t>(size) * size, ' ');
+	Format(&facelets[0]);
+	return facelets;
+}
+
+CubeFace PersistentSurface::GetSticker(CubeFace face, int row, int column) const
+{
+	CubeSurface::GetOwnRowAndColumn(size, frame, face, row, column);
+
+	int storedRow, storedColumn;
+	CubeSurface::GetStoredRowAndColumn(size, faceTurns[face], row, column, storedRow, storedColumn);
+
+	return static_cast<CubeFace>(GetStoredSticker(face, storedRow, storedColumn));
+}
+
+size_t PersistentSurface::GetNumberOfSharedTiles(const PersistentSurface& other) const
+{
+	if (other.size != size) {
+		return 0;
+	}
+
+	size_t count = 0;
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		for (size_t i = 0; i < faces[face]->size(); i++) {
+			count += (*faces[face])[i] == (*other.faces[face])[i];
+		}
+	}
+
+	return count;
+}
+
+uint8_t PersistentSurface::GetStoredSticker(CubeFace face, int storedRow, int storedColumn) const
+{
+	const Tile& tile = *(*faces[face])[GetTileIndex(storedRow, storedColumn)];
+	return tile[(storedRow % TILE_SIZE) * TILE_SIZE + storedColumn % TILE_SIZE];
+}
+
+int PersistentSurface::GetTileRun(int storedRow, int storedColumn, int rowStep, int columnStep, int remaining)
+{
+	int count = remaining;
+	if (rowStep != 0) {
+		int left = rowStep > 0 ? TILE_SIZE - storedRow % TILE_SIZE : storedRow % TILE_SIZE + 1;
+		count = left < count ? left : count;
+	}
+	if (columnStep != 0) {
+		int left = columnStep > 0 ? TILE_SIZE - storedColumn % TILE_SIZE : storedColumn % TILE_SIZE + 1;
+		count = left < count ? left : count;
+	}
+
+	return count;
+}
\ No newline at end of file
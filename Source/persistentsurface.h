@@ -0,0 +1,68 @@
+/*
+	The main purpose of this class is to let a solver, the renderer and a history viewer each hold their own NxNxN cube, current or past,
+	without locks and without copying every sticker. A PersistentSurface is a value whose copies are snapshots: copying one costs six
+	shared pointers and seven bytes whatever the size, and turning a copy never changes what the other copies see.
+
+	Stickers follow the layout of CubeSurface (same faces, rows, columns, face orientation tags and frame), but each face is cut into tiles of
+	TILE_SIZE x TILE_SIZE stickers reached through shared pointers. A slice turn builds new faces for the four faces around it, which copy
+	the tile pointers of the old ones and replace only the tiles its ring crosses (about 4 * size / TILE_SIZE tiles). Every other tile
+	stays shared with the surfaces it came from, and a solved cube holds a single tile per face.
+
+	Tiles and faces are never written once built, and their reference counts are atomic, so copies can be handed to other threads (through
+	a TripleBuffer, a CubeHistory whose snapshots then share their tiles, or any other channel), read there and released in any order
+	while the writer keeps turning its own copy. Only one thread may use a given PersistentSurface object at a time, like any value.
+*/
+
+#pragma once
+
+#include "cubemoves.h"
+#include "cuberotation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PersistentSurface {
+public:
+	static const int TILE_SIZE = 32;
+
+	PersistentSurface(int size); // Creates a solved cube with size cubies along each edge
+	virtual ~PersistentSurface();
+
+	// Same conventions as CubeSurface
+	void ApplySliceTurn(CubeAxis axis, int slice, int quarterTurns);
+	void ApplyFaceTurn(CubeFace face, int quarterTurns);
+	void ApplyRotation(CubeAxis axis, int quarterTurns); // Only changes the frame, so every tile stays shared
+
+	bool IsSolved() const; // True when every face has a single color, whatever the orientation of the whole cube
+
+	// Writes 6 * size * size characters, without null terminator
+	void Format(char* facelets) const;
+	std::string Format() const;
+
+	// Getters
+	int GetSize() const { return size; }
+	int GetFrame() const { return frame; }
+	CubeFace GetSticker(CubeFace face, int row, int column) const;
+	bool GetIsSharingFace(const PersistentSurface& other, CubeFace face) const { return faces[face] == other.faces[face]; } // Neither turned the face (in the own axes of the cube) since they split
+	size_t GetNumberOfSharedTiles(const PersistentSurface& other) const; // Tiles both surfaces point to
+
+protected:
+	typedef std::vector<uint8_t> Tile; // TILE_SIZE * TILE_SIZE stickers, row by row (the last tiles of a line are not full)
+	typedef std::vector<std::shared_ptr<const Tile>> Face; // tilesPerLine * tilesPerLine tiles, row by row
+
+	int size;
+	int tilesPerLine;
+
+	std::shared_ptr<const Face> faces[NUMBER_OF_FACES];
+	uint8_t faceTurns[NUMBER_OF_FACES]; // Orientation tags, as in CubeSurface
+	uint8_t frame; // Rotation carrying the own axes of the cube to the world, as in CubeSurface
+
+	uint8_t GetStoredSticker(CubeFace face, int storedRow, int storedColumn) const; // Sticker at a row and column of the array of a face
+	size_t GetTileIndex(int storedRow, int storedColumn) const { return static_cast<size_t>(storedRow / TILE_SIZE) * tilesPerLine + storedColumn / TILE_SIZE; }
+
+	// Number of stickers, at most remaining, that a line going by the given steps still has in the tile of its current sticker
+	static int GetTileRun(int storedRow, int storedColumn, int rowStep, int columnStep, int remaining);
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "renderer.h"
+#include "cube.h"
+#include "impostor.h"
+#include "scenesnapshot.h"
+#include "utils.h"
+
+#include <mutex>
+#include <thread>
+
+#define GLEW_STATIC 1
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+Renderer::Renderer(GLFWwindow* window, GLuint sceneShader, GLuint impostorShader)
+{
+	this->window = window;
+	this->sceneShader = sceneShader;
+	this->impostorShader = impostorShader;
+
+	isRunning = false;
+	renderedFrameCount = 0;
+}
+
+Renderer::~Renderer()
+{
+	Stop();
+}
+
+void Renderer::Start()
+{
+	if (isRunning.load()) {
+		return;
+	}
+
+	isRunning = true;
+	renderThread = std::thread(&Renderer::Run, this);
+}
+
+void Renderer::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(publishMutex);
+		isRunning = false;
+	}
+	snapshotPublished.notify_one();
+
+	if (renderThread.joinable()) {
+		renderThread.join();
+	}
+}
+
+void Renderer::PublishSnapshot()
+{
+	{
+		std::lock_guard<std::mutex> lock(publishMutex);
+		snapshots.Publish();
+	}
+	snapshotPublished.notify_one();
+}
+
+void Renderer::Run()
+{
+	glfwMakeContextCurrent(window);
+
+	{
+		// These own OpenGL objects, so they live and die on this thread while the context is current.
+		// All the cubes look the same, a single model provides the geometry for every cube of every snapshot.
+		Cube cubeModel(glm::vec3(0.0f, 0.0f, 0.0f));
+		cubeModel.CreateVertexArrayObject();
+		ImpostorCache impostorCache(sceneShader, impostorShader, cubeModel.GetVertexArrayObject());
+
+		while (isRunning.load()) {
+			{
+				// Nothing new from the simulation yet, sleep until it publishes or the renderer stops
+				std::unique_lock<std::mutex> lock(publishMutex);
+				while (isRunning.load() && !snapshots.Acquire()) {
+					snapshotPublished.wait(lock);
+				}
+			}
+
+			if (!isRunning.load()) {
+				break;
+			}
+
+			RenderSnapshot(snapshots.GetReadBuffer(), impostorCache);
+			glfwSwapBuffers(window);
+			renderedFrameCount++;
+		}
+	}
+
+	glfwMakeContextCurrent(NULL);
+}
+
+void Renderer::RenderSnapshot(const SceneSnapshot& snapshot, ImpostorCache& impostorCache)
+{
+	glUseProgram(sceneShader);
+
+	// Set view position on scene shader
+	SetUniformVec3(sceneShader, "view_position", snapshot.cameraPosition);
+
+	// Use proper image output size
+	glViewport(0, 0, snapshot.framebufferWidth, snapshot.framebufferHeight);
+
+	// Bind screen as output framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	SetUniformMat4(sceneShader, "projectionMatrix", snapshot.projectionMatrix);
+	SetUniformMat4(sceneShader, "viewMatrix", snapshot.viewMatrix);
+
+	for (size_t i = 0; i < snapshot.rubiks.size(); i++) {
+		impostorCache.Draw(snapshot.rubiks[i], snapshot.cameraPosition, snapshot.viewMatrix, snapshot.projectionMatrix);
+	}
+}
\ No newline at end of file
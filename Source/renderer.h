@@ -0,0 +1,57 @@
+/*
+	The main purpose of this class is to own the OpenGL context on a dedicated thread. The simulation (main) thread publishes a
+	SceneSnapshot every step through a lock-free triple buffer and the render thread always draws the latest complete one, so vsync
+	and GPU stalls never delay input handling or the animations, and the simulation never waits for the renderer. The render thread
+	sleeps on a condition variable while nothing new has been published.
+*/
+
+#pragma once
+
+#include "cube.h"
+#include "impostor.h"
+#include "scenesnapshot.h"
+#include "triplebuffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define GLEW_STATIC 1
+#include <GL/glew.h>
+
+#include <GLFW/glfw3.h>
+
+class Renderer {
+public:
+	Renderer(GLFWwindow* window, GLuint sceneShader, GLuint impostorShader);
+	virtual ~Renderer();
+
+	// The OpenGL context of the window must not be current on the calling thread, it is made current on the render thread.
+	void Start();
+	void Stop();
+
+	// Called by the simulation thread: fill the snapshot returned by BeginSnapshot, then publish it with PublishSnapshot.
+	SceneSnapshot& BeginSnapshot() { return snapshots.GetWriteBuffer(); }
+	void PublishSnapshot();
+
+	// Getters
+	bool GetIsRunning() const { return isRunning.load(); }
+	unsigned int GetRenderedFrameCount() const { return renderedFrameCount.load(); }
+
+protected:
+	GLFWwindow* window;
+	GLuint sceneShader;
+	GLuint impostorShader;
+
+	std::thread renderThread;
+	std::atomic<bool> isRunning;
+	std::atomic<unsigned int> renderedFrameCount;
+
+	TripleBuffer<SceneSnapshot> snapshots;
+	std::mutex publishMutex; // Only guards the wake up of the render thread, the snapshots themselves go through the triple buffer
+	std::condition_variable snapshotPublished;
+
+	void Run(); // Body of the render thread
+	void RenderSnapshot(const SceneSnapshot& snapshot, ImpostorCache& impostorCache);
+};
\ No newline at end of file
@@ -1,6 +1,14 @@
 #include "rubik.h"
 #include "cube.h"
-
+#include "cubealgorithm.h"
+#include "cubefacelets.h"
+#include "cubemoves.h"
+#include "cuberotation.h"
+#include "cubestate.h"
+#include "cubesurface.h"
+#include "cubezobrist.h"
+
+#include <string>
 #include <vector>
 
 #define GLEW_STATIC 1
@@ -11,15 +19,23 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-Rubik::Rubik(glm::vec3 position, GLuint shader)
+static const char FACE_NAMES[NUMBER_OF_FACES + 1] = "URFDLB";
+
+template <int X, int Y, int Z>
+Rubik<X, Y, Z>::Rubik(glm::vec3 position, GLuint shader)
 {
 	this->SetPosition(position);
 
 	isAnimated = false;
+	revision = 0;
+	numberOfAnimatedCubes = 0;
+	cubeStateHash = CubeZobrist::GetHash(cubeState);
 
 	this->rubikTransformations.translation = glm::translate(glm::mat4(1.0f), position);
 	this->rubikTransformations.rotation = glm::mat4(1.0f);
 	this->rubikTransformations.scaling = glm::mat4(1.0f);
+	this->rubikTransformations.pivot = glm::vec3(X, Y, Z) * 0.5f;
+	viewFrame = CubeRotation::IDENTITY;
 
 	// Create the Cubes
 	int i = 0;
@@ -32,6 +48,7 @@ Rubik::Rubik(glm::vec3 position, GLuint shader)
 
 				this->cubes.push_back(new Cube(glm::vec3(x, y, z)));
 				this->cubes.at(i)->SetShader(shader);
+				this->cubes.at(i)->SetPivot(rubikTransformations.pivot); // Every turn goes through the center of the Rubik's cube
 				i++;
 			}
 		}
@@ -50,40 +67,24 @@ Rubik::Rubik(glm::vec3 position, GLuint shader)
 	this->selectedRubikSection = 0;
 	this->selectedRubikSectionType = LAYER;
 
-	this->GetRubikLayerCubes(0, selectedCubes);
+	this->GetRubikSectionCubes(LAYER, 0, selectedCubes);
 
-	for (int i = 0; i < NUMBER_OF_LAYERS * NUMBER_OF_ROWS; i++) {
+	for (int i = 0; i < SLICE_TABLES.numberOfSectionCubes[LAYER]; i++) {
 		cubes.at(selectedCubes[i])->SetIsSelected(true);
 	}
 }
 
-Rubik::~Rubik()
-{
-	cubes.clear();
-}
-
-void Rubik::Draw()
+template <int X, int Y, int Z>
+Rubik<X, Y, Z>::~Rubik()
 {
-	for (int i = 0; i < this->NUMBER_OF_CUBES; i++) {
-		cubes.at(i)->Draw(this->rubikTransformations);
-
-		if (isAnimated && cubes.at(i)->GetIsSelected()) {
-			// The pivot calculation is referenced from https://community.khronos.org/t/rotation-at-the-specified-pivot-point/46463
-			glm::mat4 currentRotation = cubes.at(i)->GetRotation();
-			glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), cubeRotationAnimationIncrement, cubeRotationAnimationDirection);
-			glm::vec3 distanceWithPivot = cubes.at(i)->GetPosition() - cubes.at(i)->GetPivot();
-
-			glm::mat4 cubeRotationMatrix = glm::translate(glm::mat4(1.0f), -distanceWithPivot) * rotation * glm::translate(glm::mat4(1.0f), distanceWithPivot);
-			cubeRotationMatrix = cubeRotationMatrix * currentRotation;
-
-			cubes.at(i)->SetRotation(cubeRotationMatrix);
-		}
+	for (size_t i = 0; i < cubes.size(); i++) {
+		delete cubes[i];
 	}
-
-	Update();
+	cubes.clear();
 }
 
-void Rubik::Update()
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::Update()
 {
 	if (isAnimated) {
 		// add increment to current angle
@@ -94,48 +95,280 @@ void Rubik::Update()
 			cubeRotationAnimationCurrentAngle = cubeRotationAnimationEndAngle;
 			SetIsAnimated(false);
 		}
+
+		// The cubes already rest in their new orientation, they are only shown the remaining angle away from it
+		SetCubesTurnAngle(animatedCubes, numberOfAnimatedCubes, cubeRotationAnimationAxis, cubeRotationAnimationCurrentAngle - cubeRotationAnimationEndAngle);
+	}
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::FillSnapshot(RubikSnapshot& snapshot) const
+{
+	snapshot.id = this;
+	snapshot.revision = revision;
+	snapshot.isAnimated = isAnimated;
+	Transformations transformations = GetViewTransformations();
+	snapshot.rotation = transformations.rotation;
+	snapshot.center = GetCenter();
+	snapshot.boundingRadius = GetBoundingRadius();
+
+	snapshot.selectedSection = selectedRubikSection;
+	snapshot.selectedSectionType = selectedRubikSectionType;
+
+	snapshot.cubes.resize(NUMBER_OF_CUBES);
+	for (int i = 0; i < NUMBER_OF_CUBES; i++) {
+		snapshot.cubes[i].worldMatrix = cubes.at(i)->GetWorldMatrix(transformations);
+		snapshot.cubes[i].isSelected = cubes.at(i)->GetIsSelected();
 	}
 }
 
-void Rubik::SetPosition(glm::vec3 position)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetPosition(glm::vec3 position)
 {
 	this->position = position;
 }
 
-void Rubik::SetIsAnimated(bool isAnimated)
+template <int X, int Y, int Z>
+glm::vec3 Rubik<X, Y, Z>::GetCenter() const
+{
+	glm::vec3 localCenter = glm::vec3(NUMBER_OF_COLUMNS * Cube::CUBE_WIDTH, NUMBER_OF_LAYERS * Cube::CUBE_HEIGHT, NUMBER_OF_ROWS * Cube::CUBE_DEPTH) * 0.5f;
+	return glm::vec3(rubikTransformations.translation * glm::vec4(localCenter, 1.0f));
+}
+
+template <int X, int Y, int Z>
+float Rubik<X, Y, Z>::GetBoundingRadius() const
+{
+	glm::vec3 halfExtents = glm::vec3(NUMBER_OF_COLUMNS * Cube::CUBE_WIDTH, NUMBER_OF_LAYERS * Cube::CUBE_HEIGHT, NUMBER_OF_ROWS * Cube::CUBE_DEPTH) * 0.5f;
+	float scale = glm::max(glm::length(glm::vec3(rubikTransformations.scaling[0])), glm::max(glm::length(glm::vec3(rubikTransformations.scaling[1])), glm::length(glm::vec3(rubikTransformations.scaling[2]))));
+	return glm::length(halfExtents) * scale;
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetIsAnimated(bool isAnimated)
 {
 	this->isAnimated = isAnimated;
 }
 
-void Rubik::SetTranslation(glm::mat4 translation)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetTranslation(glm::mat4 translation)
 {
 	this->rubikTransformations.translation = translation;
+	revision++;
 }
 
-void Rubik::SetScaling(glm::mat4 scaling)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetScaling(glm::mat4 scaling)
 {
 	this->rubikTransformations.scaling = scaling;
+	revision++;
 }
 
-void Rubik::SetRotation(glm::mat4 rotation)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetRotation(glm::mat4 rotation)
 {
 	this->rubikTransformations.rotation = rotation;
 }
 
-void Rubik::SetShader(GLuint shader)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetShader(GLuint shader)
 {
 	for (int i = 0; i < NUMBER_OF_CUBES; i++) {
 		cubes.at(i)->SetShader(shader);
 	}
 }
 
-void Rubik::SetSelectedRubikSection(int selectedSection)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::Reset()
+{
+	SetIsAnimated(false);
+	SetCubesTurnAngle(animatedCubes, numberOfAnimatedCubes, AXIS_X, 0.0f);
+	numberOfAnimatedCubes = 0;
+
+	cubeState = CubeState();
+	cubeStateHash = CubeZobrist::GetHash(cubeState);
+	viewFrame = CubeRotation::IDENTITY;
+
+	// Every cube back at the position it was created at, in its resting orientation
+	for (int i = 0; i < NUMBER_OF_CUBES; i++) {
+		rubikMatrix[i / NUMBER_OF_COLUMNS][i % NUMBER_OF_COLUMNS] = i;
+		cubes.at(i)->SetOrientation(CubeRotation::IDENTITY);
+	}
+
+	UpdateSelectedCubes();
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetSelectedRubikSection(int selectedSection)
 {
 	this->selectedRubikSection = selectedSection;
 	UpdateSelectedCubes();
 }
 
-void Rubik::SwitchRubikSelectedSectionType(bool forward)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetCubeState(const CubeState& state)
+{
+	if (!IS_STANDARD) {
+		return;
+	}
+
+	cubeState = state;
+	cubeStateHash = CubeZobrist::GetHash(state);
+	SetIsAnimated(false);
+
+	char facelets[CubeFacelets::NUMBER_OF_FACELETS];
+	CubeFacelets::Format(state, facelets);
+
+	// Collect the stickers seen at each position of the Rubik's cube (positions and normals in cubie units from its center)
+	int stickerCounts[NUMBER_OF_CUBES] = {};
+	int stickerNormals[NUMBER_OF_CUBES][3][3];
+	CubeFace stickerColors[NUMBER_OF_CUBES][3];
+	for (int i = 0; i < CubeFacelets::NUMBER_OF_FACELETS; i++) {
+		int position[3];
+		CubeFacelets::GetFaceletPosition(i, position);
+
+		int cube = (position[1] + 1) * NUMBER_OF_ROWS * NUMBER_OF_COLUMNS + (position[2] + 1) * NUMBER_OF_COLUMNS + (position[0] + 1);
+		CubeFacelets::GetFaceNormal(CubeFacelets::GetFaceletFace(i), stickerNormals[cube][stickerCounts[cube]]);
+		stickerColors[cube][stickerCounts[cube]] = CubeFacelets::GetFaceFromName(facelets[i]);
+		stickerCounts[cube]++;
+	}
+
+	SetCubesTurnAngle(animatedCubes, numberOfAnimatedCubes, AXIS_X, 0.0f);
+
+	for (int position = 0; position < NUMBER_OF_CUBES; position++) {
+		int layer = position / (NUMBER_OF_ROWS * NUMBER_OF_COLUMNS);
+		int row = (position / NUMBER_OF_COLUMNS) % NUMBER_OF_ROWS;
+		int column = position % NUMBER_OF_COLUMNS;
+		int worldPosition[3] = { column - 1, layer - 1, row - 1 };
+
+		// Centers and the core turn with the whole cube (how far a center is spun around its face cannot be seen). Any other cube is
+		// the one with the colors of its stickers, turned so that each color faces the way it is seen.
+		int rotation = state.GetFrame();
+		int homePosition[3];
+		const int8_t (*matrix)[3] = CubeRotation::GetMatrix(CubeRotation::Inverse(rotation));
+		for (int i = 0; i < 3; i++) {
+			homePosition[i] = matrix[i][0] * worldPosition[0] + matrix[i][1] * worldPosition[1] + matrix[i][2] * worldPosition[2];
+		}
+
+		if (stickerCounts[position] >= 2) {
+			int colorNormals[3][3];
+			for (int i = 0; i < 3; i++) {
+				homePosition[i] = 0;
+			}
+			for (int k = 0; k < stickerCounts[position]; k++) {
+				CubeFacelets::GetFaceNormal(stickerColors[position][k], colorNormals[k]);
+				for (int i = 0; i < 3; i++) {
+					homePosition[i] += colorNormals[k][i];
+				}
+			}
+
+			for (rotation = 0; rotation < CubeRotation::NUMBER_OF_ROTATIONS; rotation++) {
+				matrix = CubeRotation::GetMatrix(rotation);
+
+				bool isMatching = true;
+				for (int k = 0; k < stickerCounts[position] && isMatching; k++) {
+					for (int i = 0; i < 3; i++) {
+						if (matrix[i][0] * colorNormals[k][0] + matrix[i][1] * colorNormals[k][1] + matrix[i][2] * colorNormals[k][2] != stickerNormals[position][k][i]) {
+							isMatching = false;
+						}
+					}
+				}
+
+				if (isMatching) {
+					break;
+				}
+			}
+		}
+
+		int cube = (homePosition[1] + 1) * NUMBER_OF_ROWS * NUMBER_OF_COLUMNS + (homePosition[2] + 1) * NUMBER_OF_COLUMNS + (homePosition[0] + 1);
+		rubikMatrix[layer * NUMBER_OF_ROWS + row][column] = cube;
+		cubes.at(cube)->SetOrientation(rotation);
+	}
+
+	UpdateSelectedCubes();
+}
+
+template <int X, int Y, int Z>
+CubeFacelets::Error Rubik<X, Y, Z>::SetFacelets(const std::string& facelets)
+{
+	if (!IS_STANDARD) {
+		return CubeFacelets::INVALID_LENGTH;
+	}
+
+	CubeState state;
+	CubeFacelets::Error error = CubeFacelets::Parse(facelets, state);
+	if (error == CubeFacelets::FACELETS_VALID) {
+		SetViewCubeState(state);
+	}
+
+	return error;
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetViewCubeState(const CubeState& state)
+{
+	// Pieces are relative to the centers, only the frame tells how the cube is held
+	CubeState ownState = state;
+	ownState.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(CubeRotation::Compose(CubeRotation::Inverse(viewFrame), state.GetFrame()));
+	SetCubeState(ownState);
+}
+
+template <int X, int Y, int Z>
+CubeState Rubik<X, Y, Z>::GetViewCubeState() const
+{
+	CubeState state = cubeState;
+	state.bytes[CubeState::FRAME_OFFSET] = static_cast<uint8_t>(CubeRotation::Compose(viewFrame, cubeState.GetFrame()));
+	return state;
+}
+
+template <int X, int Y, int Z>
+std::string Rubik<X, Y, Z>::GetStickers() const
+{
+	if (X != Y || X != Z) {
+		return std::string();
+	}
+
+	std::string stickers(NUMBER_OF_FACES * static_cast<size_t>(X) * X, ' ');
+	int inverseViewFrame = CubeRotation::Inverse(viewFrame);
+
+	size_t i = 0;
+	for (int face = 0; face < NUMBER_OF_FACES; face++) {
+		// The world face is some face of the Rubik's cube in its own axes
+		CubeFace ownFace = CubeRotation::RotateFace(inverseViewFrame, static_cast<CubeFace>(face));
+
+		for (int row = 0; row < X; row++) {
+			for (int column = 0; column < X; column++) {
+				int worldPosition[3], position[3];
+				CubeSurface::GetPosition(X, static_cast<CubeFace>(face), row, column, worldPosition);
+				CubeSurface::RotatePosition(X, inverseViewFrame, worldPosition, position);
+
+				// A cube shows on each side the color of the side that faced that way before it was turned
+				const Cube* cube = cubes.at(rubikMatrix[position[1] * Z + position[2]][position[0]]);
+				stickers[i++] = FACE_NAMES[CubeRotation::RotateFace(CubeRotation::Inverse(cube->GetOrientation()), ownFace)];
+			}
+		}
+	}
+
+	return stickers;
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::ApplyAlgorithm(const CubeAlgorithm& algorithm)
+{
+	if (!IS_STANDARD) {
+		return;
+	}
+
+	CubeState state = GetViewCubeState();
+	algorithm.Apply(state);
+
+	// The whole cube rotations of the algorithm go to the view frame, so the cubes only move for the turns
+	viewFrame = CubeRotation::Compose(algorithm.GetRotation(), viewFrame);
+
+	SetViewCubeState(state);
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SwitchRubikSelectedSectionType(bool forward)
 {
 	if (selectedRubikSectionType == LAYER) {
 		selectedRubikSectionType = forward ? HORIZONTAL_CROSS_LAYER : VERTICAL_CROSS_LAYER;
@@ -147,186 +380,298 @@ void Rubik::SwitchRubikSelectedSectionType(bool forward)
 		selectedRubikSectionType = forward ? LAYER : HORIZONTAL_CROSS_LAYER;
 	}
 
+	// Cuboids do not have as many slices along every axis
+	if (selectedRubikSection >= GetNumberOfSections(selectedRubikSectionType)) {
+		selectedRubikSection = GetNumberOfSections(selectedRubikSectionType) - 1;
+	}
+
 	UpdateSelectedCubes();
 }
 
-void Rubik::RotateRubikSelectedSection(bool forward)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::RotateRubikSelectedSection(bool forward)
 {
-	cubeRotationAnimationCurrentAngle = glm::radians(0.0f);
-	cubeRotationAnimationIncrement = forward ? glm::radians(1.0f) : glm::radians(-1.0f);
-	cubeRotationAnimationEndAngle = forward ? glm::radians(90.0f) : glm::radians(-90.0f);
+	ApplySliceTurn(GetSelectedSliceTurn(forward), true);
+}
 
-	if (selectedRubikSectionType == LAYER) {
-		// Set up rotation animation
-		cubeRotationAnimationDirection = glm::vec3(0.0f, 1.0f, 0.0f);
-		SetSelectedCubesPivot(glm::vec3(1.5f, selectedRubikSection, 1.5f));
-
-		// Since some cubes are going to be rotated, update the configuration of the cubes within the rubikMatrix.
-		int start = selectedRubikSection * NUMBER_OF_ROWS;
-		int max = start + NUMBER_OF_ROWS;
-		int newRubikSectionConfiguration[NUMBER_OF_ROWS][NUMBER_OF_COLUMNS];
-		 
-		if (forward) {
-			for (int rubikColumn = NUMBER_OF_COLUMNS - 1, i = 0; rubikColumn >= 0; rubikColumn--, i++) {
-				for (int rubikRow = start, j = 0; rubikRow < max; rubikRow++, j++) {
-					newRubikSectionConfiguration[i][j] = rubikMatrix[rubikRow][rubikColumn];
-				}
-			}
-		}
-		else {
-			for (int rubikColumn = 0, i = 0; rubikColumn < NUMBER_OF_COLUMNS; rubikColumn++, i++) {
-				for (int rubikRow = max - 1, j = 0; rubikRow >= start; rubikRow--, j++) {
-					newRubikSectionConfiguration[i][j] = rubikMatrix[rubikRow][rubikColumn];
-				}
-			}
-		}
+template <int X, int Y, int Z>
+SliceTurn Rubik<X, Y, Z>::GetSelectedSliceTurn(bool forward) const
+{
+	SliceTurn turn;
+	turn.axis = GetRubikSectionAxis(selectedRubikSectionType);
+	turn.slice = selectedRubikSection;
+	turn.quarterTurns = !GetCanQuarterTurn(turn.axis) ? 2 : (forward ? 1 : -1);
+	return turn;
+}
 
-		for (int rubikRow = start, i = 0; rubikRow < max; rubikRow++, i++) {
-			for (int rubikColumn = 0, j = 0; rubikColumn < NUMBER_OF_COLUMNS; rubikColumn++, j++) {
-				rubikMatrix[rubikRow][rubikColumn] = newRubikSectionConfiguration[i][j];
-			}
-		}
-	} else if (selectedRubikSectionType == HORIZONTAL_CROSS_LAYER) {
-		// Set up rotation animation
-		cubeRotationAnimationDirection = glm::vec3(0.0f, 0.0f, 1.0f);
-		SetSelectedCubesPivot(glm::vec3(1.5f, 1.5f, selectedRubikSection));
-
-		// Since some cubes are going to be rotated, update the configuration of the cubes within the rubikMatrix.
-		int start = selectedRubikSection;
-		int max = selectedRubikSection + ((NUMBER_OF_ROWS - 1) * NUMBER_OF_LAYERS);
-		int increment = NUMBER_OF_LAYERS;
-		int newRubikSectionConfiguration[NUMBER_OF_LAYERS][NUMBER_OF_COLUMNS];
-
-		if (!forward) {
-			for (int rubikColumn = NUMBER_OF_COLUMNS - 1, i = 0; rubikColumn >= 0; rubikColumn--, i++) {
-				for (int rubikRow = start, j = 0; rubikRow <= max; rubikRow += increment, j++) {
-					newRubikSectionConfiguration[i][j] = rubikMatrix[rubikRow][rubikColumn];
-				}
-			}
-		}
-		else {
-			for (int rubikColumn = 0, i = 0; rubikColumn < NUMBER_OF_COLUMNS; rubikColumn++, i++) {
-				for (int rubikRow = max, j = 0; rubikRow >= start; rubikRow -= increment, j++) {
-					newRubikSectionConfiguration[i][j] = rubikMatrix[rubikRow][rubikColumn];
-				}
-			}
-		}
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::ApplySliceTurn(const SliceTurn& turn, bool isAnimated)
+{
+	ApplyWideTurn(turn, 1, isAnimated);
+}
 
-		for (int rubikRow = start, i = 0; rubikRow <= max; rubikRow += increment, i++) {
-			for (int rubikColumn = 0, j = 0; rubikColumn < NUMBER_OF_COLUMNS; rubikColumn++, j++) {
-				rubikMatrix[rubikRow][rubikColumn] = newRubikSectionConfiguration[i][j];
-			}
-		}
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::ApplyWideTurn(const SliceTurn& turn, int numberOfSlices, bool isAnimated)
+{
+	int quarterTurns = turn.quarterTurns & 3;
+	if (quarterTurns == 0 || numberOfSlices < 1 || (quarterTurns != 2 && !GetCanQuarterTurn(turn.axis))) {
+		return;
 	}
-	else if (selectedRubikSectionType == VERTICAL_CROSS_LAYER) {
-		// Set up rotation animation
-		cubeRotationAnimationDirection = glm::vec3(1.0f, 0.0f, 0.0f);
-		SetSelectedCubesPivot(glm::vec3(selectedRubikSection, 1.5f, 1.5f));
 
-		// Since some cubes are going to be rotated, update the configuration of the cubes within the rubikMatrix.
-		int newRubikSectionConfiguration[NUMBER_OF_ROWS][NUMBER_OF_LAYERS];
+	// Since some cubes are going to be rotated, update the configuration of the cubes within the rubikMatrix
+	RubikSection sectionType = GetAxisRubikSection(turn.axis);
+	int endSlice = turn.slice + numberOfSlices;
+	TurnRubikMatrixSlices(sectionType, turn.slice, endSlice, quarterTurns);
 
-		if (forward) {
-			for (int rubikRow = NUMBER_OF_ROWS - 1, i = 0; rubikRow >= 0; rubikRow--, i++) {
-				for (int rubikLayer = 0, j = 0; rubikLayer < NUMBER_OF_LAYERS; rubikLayer++, j++) {
-					newRubikSectionConfiguration[i][j] = rubikMatrix[rubikRow + rubikLayer * NUMBER_OF_ROWS][selectedRubikSection];
-				}
-			}
-		}
-		else {
-			for (int rubikRow = 0, i = 0; rubikRow < NUMBER_OF_ROWS; rubikRow++, i++) {
-				for (int rubikLayer = NUMBER_OF_LAYERS - 1, j = 0; rubikLayer >= 0; rubikLayer--, j++) {
-					newRubikSectionConfiguration[i][j] = rubikMatrix[rubikRow + rubikLayer * NUMBER_OF_ROWS][selectedRubikSection];
-				}
-			}
-		}
-		
-		int i = 0;
-		for (int row = 0; row < NUMBER_OF_ROWS; row++) {
-			for (int column = 0; column < NUMBER_OF_COLUMNS; column++) {
-				rubikMatrix[i][selectedRubikSection] = newRubikSectionConfiguration[row][column];
-				i++;
-			}
+	if (IS_STANDARD) {
+		for (int slice = turn.slice; slice < endSlice; slice++) {
+			CubeZobrist::ApplySliceTurn(cubeState, cubeStateHash, turn.axis, slice, quarterTurns);
 		}
 	}
 
-	SetIsAnimated(true);
+	// A turn still being animated ends at once
+	SetCubesTurnAngle(animatedCubes, numberOfAnimatedCubes, turn.axis, 0.0f);
+
+	// The slices turn around their axis, through the center of the Rubik's cube
+	int numberOfSectionCubes = SLICE_TABLES.numberOfSectionCubes[sectionType];
+	numberOfAnimatedCubes = numberOfSlices * numberOfSectionCubes;
+	for (int slice = turn.slice; slice < endSlice; slice++) {
+		GetRubikSectionCubes(sectionType, slice, animatedCubes + (slice - turn.slice) * numberOfSectionCubes);
+	}
+	TurnCubes(animatedCubes, numberOfAnimatedCubes, CubeRotation::FromAxis(turn.axis, quarterTurns));
+
+	if (isAnimated) {
+		// The animation lasts 90 steps whatever the angle
+		float angle = glm::radians(quarterTurns == 3 ? -90.0f : 90.0f * quarterTurns);
+		cubeRotationAnimationCurrentAngle = glm::radians(0.0f);
+		cubeRotationAnimationIncrement = angle / 90.0f;
+		cubeRotationAnimationEndAngle = angle;
+		cubeRotationAnimationAxis = turn.axis;
+		SetCubesTurnAngle(animatedCubes, numberOfAnimatedCubes, turn.axis, -angle);
+	}
+
+	// Turning another slice may bring other cubes into the selected section
+	UpdateSelectedCubes();
+	SetIsAnimated(isAnimated);
 }
 
-int * Rubik::GetRubikLayerCubes(int layer, int indices[])
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::ApplyMove(int move, bool isAnimated)
 {
-	int i = 0;
-	for (int layerSection = layer * NUMBER_OF_ROWS; layerSection < (layer * NUMBER_OF_ROWS) + NUMBER_OF_ROWS; layerSection++) {
-		for (int column = 0; column < NUMBER_OF_COLUMNS; column++) {
-			indices[i] = this->rubikMatrix[layerSection][column];
-			i++;
+	if (CubeMoves::GetFamily(move) >= CubeMoves::X) {
+		LayerTurns rotationTurns = CubeMoves::GetLayerTurns(move);
+		ApplyRotation(rotationTurns.axis, rotationTurns.layers[1]);
+		return;
+	}
+
+	// Layers 0 and 2 of the move are the outer slices, and layer 1 stands for the inner ones
+	LayerTurns layerTurns = CubeMoves::GetFrameLayerTurns(CubeMoves::GetLayerTurns(move), viewFrame);
+	int numberOfAxisSlices = GetNumberOfSections(GetAxisRubikSection(layerTurns.axis));
+	int firstSlices[3] = { 0, 1, numberOfAxisSlices - 1 };
+	int endSlices[3] = { 1, numberOfAxisSlices - 1, numberOfAxisSlices };
+
+	// Neighbouring layers turning the same way are one wide turn. Every move of the notation ends up as a single one, any other
+	// layer is turned first without animation.
+	SliceTurn turn;
+	turn.axis = layerTurns.axis;
+	turn.slice = 0;
+	turn.quarterTurns = 0;
+	int numberOfSlices = 0;
+
+	for (int layer = 0; layer < 3; layer++) {
+		int quarterTurns = layerTurns.layers[layer] & 3;
+		if (firstSlices[layer] >= endSlices[layer] || quarterTurns == 0) {
+			continue;
+		}
+
+		if (numberOfSlices > 0 && quarterTurns == turn.quarterTurns && turn.slice + numberOfSlices == firstSlices[layer]) {
+			numberOfSlices += endSlices[layer] - firstSlices[layer];
+			continue;
+		}
+
+		if (numberOfSlices > 0) {
+			ApplyWideTurn(turn, numberOfSlices, false);
 		}
+
+		turn.slice = firstSlices[layer];
+		turn.quarterTurns = quarterTurns;
+		numberOfSlices = endSlices[layer] - firstSlices[layer];
 	}
 
-	return indices;
+	ApplyWideTurn(turn, numberOfSlices, isAnimated);
 }
 
-int * Rubik::GetRubikHorizontalCrossLayerCubes(int crossLayer, int indices[])
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::ApplyRotation(CubeAxis axis, int quarterTurns)
 {
-	int i = 0;
-	int maxCrossLayerSection = crossLayer + ((NUMBER_OF_ROWS - 1) * NUMBER_OF_LAYERS);
-	for (int crossLayerSection = crossLayer; crossLayerSection <= maxCrossLayerSection; crossLayerSection += NUMBER_OF_ROWS) {
-		for (int column = 0; column < NUMBER_OF_COLUMNS; column++) {
-			indices[i] = this->rubikMatrix[crossLayerSection][column];
-			i++;
+	viewFrame = CubeRotation::Compose(CubeRotation::FromAxis(axis, quarterTurns), viewFrame);
+	revision++;
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::ApplySliceTurns(const SliceTurn* turns, int numberOfTurns)
+{
+	if (numberOfTurns == 0) {
+		return;
+	}
+
+	// Only the last slice is animated, with its consecutive turns merged into one
+	SliceTurn lastTurn = turns[numberOfTurns - 1];
+	lastTurn.quarterTurns = 0;
+	int firstAnimatedTurn = numberOfTurns;
+	while (firstAnimatedTurn > 0 && turns[firstAnimatedTurn - 1].axis == lastTurn.axis && turns[firstAnimatedTurn - 1].slice == lastTurn.slice) {
+		firstAnimatedTurn--;
+		lastTurn.quarterTurns += turns[firstAnimatedTurn].quarterTurns;
+	}
+
+	// The 3x3x3 is rebuilt once from its state
+	if (IS_STANDARD && firstAnimatedTurn > 0) {
+		CubeState state = cubeState;
+		for (int i = 0; i < firstAnimatedTurn; i++) {
+			state.ApplySliceTurn(turns[i].axis, turns[i].slice, turns[i].quarterTurns);
 		}
+		SetCubeState(state);
 	}
-	
-	return indices;
+	else {
+		for (int i = 0; i < firstAnimatedTurn; i++) {
+			ApplySliceTurn(turns[i], false);
+		}
+	}
+
+	ApplySliceTurn(lastTurn, true);
 }
 
-int * Rubik::GetRubikVerticalCrossLayerCubes(int crossLayer, int indices[])
+template <int X, int Y, int Z>
+int* Rubik<X, Y, Z>::GetRubikSectionCubes(RubikSection sectionType, int section, int indices[])
 {
-	int i = 0;
-	int maxRow = NUMBER_OF_ROWS * NUMBER_OF_LAYERS;
-	for (int row = 0; row < maxRow; row++) {
-			indices[i] = this->rubikMatrix[row][crossLayer];
-			i++;
+	const int* positions = SLICE_TABLES.positions[sectionType][section];
+	const int* matrix = &rubikMatrix[0][0];
+	for (int i = 0; i < SLICE_TABLES.numberOfSectionCubes[sectionType]; i++) {
+		indices[i] = matrix[positions[i]];
 	}
 
 	return indices;
 }
 
-void Rubik::UnselectAllCubes()
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::UnselectAllCubes()
 {
 	for (int cube = 0; cube < this->NUMBER_OF_CUBES; cube++) {
 		cubes.at(cube)->SetIsSelected(false);
 	}
 }
 
-void Rubik::SelectCubes(int cubeIndices[], int length)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SelectCubes(int cubeIndices[], int length)
 {
 	for (int i = 0; i < length; i++) {
 		cubes.at(cubeIndices[i])->SetIsSelected(true);
 	}
 }
 
-void Rubik::UpdateSelectedCubes()
+template <int X, int Y, int Z>
+Transformations Rubik<X, Y, Z>::GetViewTransformations() const
+{
+	const int8_t (*matrix)[3] = CubeRotation::GetMatrix(viewFrame);
+	glm::mat4 frameRotation = glm::mat4(1.0f);
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			frameRotation[j][i] = matrix[i][j];
+		}
+	}
+
+	Transformations transformations = rubikTransformations;
+	transformations.rotation = rubikTransformations.rotation * frameRotation;
+	return transformations;
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::UpdateSelectedCubes()
 {
 	UnselectAllCubes();
+	revision++;
 
-	if (selectedRubikSectionType == LAYER) {
-		GetRubikLayerCubes(selectedRubikSection, selectedCubes);
-		SelectCubes(selectedCubes, NUMBER_OF_ROWS * NUMBER_OF_COLUMNS);
+	GetRubikSectionCubes(selectedRubikSectionType, selectedRubikSection, selectedCubes);
+	SelectCubes(selectedCubes, SLICE_TABLES.numberOfSectionCubes[selectedRubikSectionType]);
+}
+
+template <int X, int Y, int Z>
+CubeAxis Rubik<X, Y, Z>::GetRubikSectionAxis(RubikSection section)
+{
+	if (section == LAYER) {
+		return AXIS_Y;
 	}
-	else if (selectedRubikSectionType == HORIZONTAL_CROSS_LAYER) {
-		GetRubikHorizontalCrossLayerCubes(selectedRubikSection, selectedCubes);
-		SelectCubes(selectedCubes, NUMBER_OF_COLUMNS * NUMBER_OF_LAYERS);
+	else if (section == HORIZONTAL_CROSS_LAYER) {
+		return AXIS_Z;
 	}
-	else if (selectedRubikSectionType == VERTICAL_CROSS_LAYER) {
-		GetRubikVerticalCrossLayerCubes(selectedRubikSection, selectedCubes);
-		SelectCubes(selectedCubes, NUMBER_OF_ROWS * NUMBER_OF_LAYERS);
+
+	return AXIS_X;
+}
+
+template <int X, int Y, int Z>
+RubikSection Rubik<X, Y, Z>::GetAxisRubikSection(CubeAxis axis)
+{
+	if (axis == AXIS_Y) {
+		return LAYER;
+	}
+	else if (axis == AXIS_Z) {
+		return HORIZONTAL_CROSS_LAYER;
 	}
+
+	return VERTICAL_CROSS_LAYER;
 }
 
-void Rubik::SetSelectedCubesPivot(glm::vec3 pivot)
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::TurnCubes(const int cubeIndices[], int numberOfCubes, int rotation)
 {
-	for (int i = 0; i < NUMBER_OF_ROWS * NUMBER_OF_LAYERS; i++) {
-		cubes.at(selectedCubes[i])->SetPivot(pivot);
+	for (int i = 0; i < numberOfCubes; i++) {
+		cubes.at(cubeIndices[i])->Turn(rotation);
 	}
 }
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::SetCubesTurnAngle(const int cubeIndices[], int numberOfCubes, CubeAxis axis, float angle)
+{
+	for (int i = 0; i < numberOfCubes; i++) {
+		cubes.at(cubeIndices[i])->SetTurnAngle(axis, angle);
+	}
+}
+
+template <int X, int Y, int Z>
+void Rubik<X, Y, Z>::TurnRubikMatrixSlices(RubikSection sectionType, int firstSlice, int endSlice, int quarterTurns)
+{
+	// Every slice of every axis turns with the same gather, whatever the number of quarter turns
+	const int* gather = SLICE_TABLES.turns[sectionType][quarterTurns & 3];
+	int numberOfSectionCubes = SLICE_TABLES.numberOfSectionCubes[sectionType];
+	int* matrix = &rubikMatrix[0][0];
+
+	for (int slice = firstSlice; slice < endSlice; slice++) {
+		const int* positions = SLICE_TABLES.positions[sectionType][slice];
+
+		int newRubikSectionConfiguration[MAX_SECTION_CUBES];
+		for (int i = 0; i < numberOfSectionCubes; i++) {
+			newRubikSectionConfiguration[i] = matrix[positions[gather[i]]];
+		}
+
+		for (int i = 0; i < numberOfSectionCubes; i++) {
+			matrix[positions[i]] = newRubikSectionConfiguration[i];
+		}
+	}
+}
+
+// Shapes that can be used, see the static_assert in rubik.h: cubes from 2x2x2 to 10x10x10, and common cuboids (X x Y x Z, Y being the height)
+template class Rubik<2>;
+template class Rubik<3>;
+template class Rubik<4>;
+template class Rubik<5>;
+template class Rubik<6>;
+template class Rubik<7>;
+template class Rubik<8>;
+template class Rubik<9>;
+template class Rubik<10>;
+template class Rubik<3, 1, 3>;
+template class Rubik<3, 2, 3>;
+template class Rubik<2, 3, 2>;
+template class Rubik<3, 4, 3>;
+template class Rubik<3, 5, 3>;
+template class Rubik<2, 3, 4>;
\ No newline at end of file
@@ -1,12 +1,39 @@
 /*
-	The main purpose of this class is to have a batch of cubes (27) and make them behave like a standard Rubik's cube.
+	The main purpose of this class is to have a batch of cubes (X * Y * Z) and make them behave like an XxYxZ Rubik's cube or cuboid (27
+	cubes for the standard 3x3x3). The shape is a template parameter (Rubik<N> is the NxNxN cube), so the slice membership and the
+	permutations of each slice for 1 to 3 quarter turns are tables built at compile time (see RubikSliceTables), and turning any number of
+	neighbouring slices by any amount is the same single table driven gather for every axis. The shapes that can be used are instantiated
+	in rubik.cpp.
+
+	Slices that are not square (the faces of a 2x2x3 or 3x3x5 cuboid that are not its ends) cannot be turned by a quarter turn without
+	jamming: their quarter turns are ignored, and the selected section of such a slice turns by half turns.
+
+	Only the 3x3x3 has a logical CubeState kept in sync with rubikMatrix. For other shapes, SetCubeState, SetFacelets (which returns
+	INVALID_LENGTH) and ApplyAlgorithm leave the Rubik's cube unchanged, and the cube state stays solved.
+
+	Any slice can be turned with ApplySliceTurn, not only the selected one, which is what undoing and redoing turns (see CubeHistory)
+	relies on. ApplySliceTurns plays several turns as a single animation, and ApplyWideTurn and ApplyMove turn several slices as one.
+
+	Slices, selections and cubeState use the own axes of the Rubik's cube. How it is held in the world is viewFrame, one of the 24 cube
+	rotations (see CubeRotation), drawn on top of rubikTransformations.rotation. A whole cube rotation (x, y or z) only changes viewFrame
+	and moves no cube, whatever the size. Moves of the notation and facelet strings describe what is seen in the world, so ApplyMove,
+	ApplyAlgorithm, SetFacelets and GetFacelets relabel faces and slices through viewFrame.
 */
 
 #pragma once
 
 #include "cube.h"
+#include "cubealgorithm.h"
+#include "cubefacelets.h"
+#include "cubemoves.h"
+#include "cubestate.h"
+#include "cubesymmetry.h"
+#include "cubezobrist.h"
+#include "scenesnapshot.h"
 #include "utils.h"
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #define GLEW_STATIC 1
@@ -15,20 +42,89 @@
 #include <GLFW/glfw3.h> 
 #include <glm/glm.hpp>
 
+enum RubikSection { LAYER, HORIZONTAL_CROSS_LAYER, VERTICAL_CROSS_LAYER, NUMBER_OF_RUBIK_SECTIONS }; // The values of this enum represent the various selection modes of a Rubik's cube
+
+// Slices of an XxYxZ Rubik's cube (X columns, Y layers and Z rows). Positions index the flattened rubikMatrix
+// (layer * Z * X + row * X + column), and the cubes of a slice are numbered a * B + b, where (a, b) is (row, column) for layers,
+// (layer, column) for horizontal cross layers and (layer, row) for vertical cross layers, and B is the number of values b takes.
+// Only square slices have quarter turns: for rectangular ones, the quarter turn tables are left as the identity.
+template <int X, int Y, int Z>
+struct RubikSliceTables {
+	static const int MAX_SLICES = X > Y ? (X > Z ? X : Z) : (Y > Z ? Y : Z);
+	static const int MAX_SECTION_CUBES = X * Z > Y * X ? (X * Z > Y * Z ? X * Z : Y * Z) : (Y * X > Y * Z ? Y * X : Y * Z);
+
+	int numberOfSlices[NUMBER_OF_RUBIK_SECTIONS];
+	int numberOfSectionCubes[NUMBER_OF_RUBIK_SECTIONS];
+	bool isSquare[NUMBER_OF_RUBIK_SECTIONS]; // Whether the slices of the section can be turned by a quarter turn
+	int positions[NUMBER_OF_RUBIK_SECTIONS][MAX_SLICES][MAX_SECTION_CUBES]; // Position of each cube of each slice
+	int turns[NUMBER_OF_RUBIK_SECTIONS][4][MAX_SECTION_CUBES]; // Cube of the slice that moves to each cube of the slice, for 0 to 3 forward quarter turns
+
+	constexpr RubikSliceTables() : numberOfSlices(), numberOfSectionCubes(), isSquare(), positions(), turns()
+	{
+		const int slices[NUMBER_OF_RUBIK_SECTIONS] = { Y, Z, X };
+		const int sizesA[NUMBER_OF_RUBIK_SECTIONS] = { Z, Y, Y };
+		const int sizesB[NUMBER_OF_RUBIK_SECTIONS] = { X, X, Z };
+
+		for (int section = 0; section < NUMBER_OF_RUBIK_SECTIONS; section++) {
+			int A = sizesA[section], B = sizesB[section];
+			numberOfSlices[section] = slices[section];
+			numberOfSectionCubes[section] = A * B;
+			isSquare[section] = A == B;
+
+			for (int a = 0; a < A; a++) {
+				for (int b = 0; b < B; b++) {
+					int i = a * B + b;
+					for (int slice = 0; slice < slices[section]; slice++) {
+						if (section == LAYER) {
+							positions[section][slice][i] = (slice * Z + a) * X + b;
+						}
+						else if (section == HORIZONTAL_CROSS_LAYER) {
+							positions[section][slice][i] = (a * Z + slice) * X + b;
+						}
+						else {
+							positions[section][slice][i] = (a * Z + b) * X + slice;
+						}
+					}
+
+					// A half turn mirrors both coordinates of any slice, a quarter turn swaps them
+					turns[section][0][i] = i;
+					turns[section][1][i] = i;
+					turns[section][2][i] = (A - 1 - a) * B + (B - 1 - b);
+					if (A == B) {
+						turns[section][1][i] = section == HORIZONTAL_CROSS_LAYER ? (A - 1 - b) * B + a : b * B + (A - 1 - a);
+					}
+				}
+			}
+
+			// Backward quarter turns gather through the forward quarter turn after the half turn, so every turn is a single pass
+			for (int i = 0; i < A * B; i++) {
+				turns[section][3][i] = turns[section][2][turns[section][1][i]];
+			}
+		}
+	}
+};
+
+template <int X, int Y = X, int Z = X>
 class Rubik {
 public:
-	static const int NUMBER_OF_ROWS = 3;
-	static const int NUMBER_OF_COLUMNS = NUMBER_OF_ROWS;
-	static const int NUMBER_OF_LAYERS = 3;
+	static_assert(X >= 1 && X <= 10 && Y >= 1 && Y <= 10 && Z >= 1 && Z <= 10, "The shapes that can be used are instantiated in rubik.cpp");
+
+	static const int NUMBER_OF_ROWS = Z;
+	static const int NUMBER_OF_COLUMNS = X;
+	static const int NUMBER_OF_LAYERS = Y;
 	static const int NUMBER_OF_CUBES = NUMBER_OF_ROWS * NUMBER_OF_COLUMNS * NUMBER_OF_LAYERS;
+	static const int MAX_SECTION_CUBES = RubikSliceTables<X, Y, Z>::MAX_SECTION_CUBES; // Cubes in the biggest slice
+	static const bool IS_STANDARD = X == 3 && Y == 3 && Z == 3; // Only the 3x3x3 has a CubeState
 
-	enum RubikSection { LAYER, HORIZONTAL_CROSS_LAYER, VERTICAL_CROSS_LAYER }; // The values of this enum represent the various selection modes of a Rubik's cube
+	static constexpr RubikSliceTables<X, Y, Z> SLICE_TABLES = RubikSliceTables<X, Y, Z>();
 
 	Rubik(glm::vec3 position, GLuint shader);
 	virtual ~Rubik();
 
-	void Draw();
-	void Update();
+	void Update(); // Advances the rotation animation of the selected section by one step
+	void Reset(); // Puts every cube back home, solved and in the identity view frame, stopping any animation
+
+	void FillSnapshot(RubikSnapshot& snapshot) const; // Copies everything the renderer needs to draw the Rubik's cube into snapshot
 
 	// Setters
 	void SetPosition(glm::vec3 position);
@@ -43,8 +139,17 @@ public:
 
 	void SetSelectedRubikSection(int selectedSection);
 
+	void SetCubeState(const CubeState& state); // Moves and turns the cubes to show the given configuration, without animation
+	void SetViewCubeState(const CubeState& state); // Same for a configuration as seen in the world, keeping the view frame
+	CubeFacelets::Error SetFacelets(const std::string& facelets); // Parses a facelet string (see CubeFacelets) and shows it if it is valid
+	void ApplyAlgorithm(const CubeAlgorithm& algorithm); // Applies a whole algorithm at once, without animation
+
 	// Getters
 	glm::vec3 GetPosition() const { return position; }
+	glm::vec3 GetCenter() const; // World space center of the Rubik's cube
+	float GetBoundingRadius() const; // Radius of the sphere enclosing the Rubik's cube in world space
+
+	unsigned int GetRevision() const { return revision; }
 
 	bool GetIsAnimated() const { return isAnimated; }
 
@@ -56,37 +161,71 @@ public:
 	int GetSelectedRubikSection() const { return selectedRubikSection; }
 	RubikSection GetSelectedRubikSectionType() const { return selectedRubikSectionType; }
 
+	static int GetNumberOfSections(RubikSection sectionType) { return SLICE_TABLES.numberOfSlices[sectionType]; }
+	static bool GetCanQuarterTurn(CubeAxis axis) { return SLICE_TABLES.isSquare[GetAxisRubikSection(axis)]; }
+
+	const CubeState& GetCubeState() const { return cubeState; }
+	bool GetIsSolved() const { return cubeState.IsSolved(); }
+	CubeState GetViewCubeState() const; // The cube state as seen in the world, with the view frame composed into its frame
+	std::string GetFacelets() const { return CubeFacelets::Format(GetViewCubeState()); }
+	int GetViewFrame() const { return viewFrame; }
+	// Stickers as seen in the world, read from rubikMatrix and the orientations of the cubes rather than from the cube state, in the
+	// layout of CubeSurface (6 * X * X letters). Empty for cuboids.
+	std::string GetStickers() const;
+	CubeState GetCanonicalCubeState() const { return CubeSymmetry::GetCanonical(cubeState); } // Same for every configuration equal up to symmetry
+	uint64_t GetCubeStateHash() const { return cubeStateHash; } // Zobrist hash of the cube state (see CubeZobrist), updated by every turn
+
 	void SwitchRubikSelectedSectionType(bool forward);
 	void RotateRubikSelectedSection(bool forward); // Perform a rotation on the selected section in the specified direction (true=forward, false=backward)
+	SliceTurn GetSelectedSliceTurn(bool forward) const; // Turn done by RotateRubikSelectedSection (a forward turn is counterclockwise around the axis, or a half turn for a rectangular slice)
+
+	void ApplySliceTurn(const SliceTurn& turn, bool isAnimated); // Quarter turns of rectangular slices are ignored, see GetCanQuarterTurn
+	void ApplySliceTurns(const SliceTurn* turns, int numberOfTurns); // Shows everything but the last turns of the last slice at once, and animates those as one turn
+	void ApplyWideTurn(const SliceTurn& turn, int numberOfSlices, bool isAnimated); // Turns numberOfSlices slices from turn.slice together
+	// Applies a move of the standard notation (see CubeMoves) as seen in the world. On bigger cubes the middle layer of the move stands for
+	// all the inner slices, so M turns every inner slice and Rw every slice but the L face.
+	void ApplyMove(int move, bool isAnimated);
+	void ApplyRotation(CubeAxis axis, int quarterTurns); // Rotates the whole Rubik's cube around a world axis by changing the view frame
 
 protected:
 	int rubikMatrix[NUMBER_OF_ROWS * NUMBER_OF_LAYERS][NUMBER_OF_COLUMNS]; // A matrix that represents the configuration/placement of the cubes within the Rubik's cube
+	CubeState cubeState; // Logical configuration of the Rubik's cube (cubie permutations and orientations), kept in sync with rubikMatrix
+	uint64_t cubeStateHash; // CubeZobrist hash of cubeState
 	std::vector<Cube*> cubes; // The Cubes that form the Rubik's cube
 
 	bool isAnimated;
 
+	unsigned int revision; // Incremented whenever the configuration, selection or placement of the Rubik's cube changes
+
 	glm::vec3 position;
 
 	Transformations rubikTransformations; // transformations applied on the Rubik's cube as a whole
+	int viewFrame; // Rotation carrying the own axes of the Rubik's cube to the world, applied before rubikTransformations.rotation
 
 	// Properties for animating the rotation of the selected section
 	float cubeRotationAnimationIncrement;
 	float cubeRotationAnimationCurrentAngle;
 	float cubeRotationAnimationEndAngle;
-	glm::vec3 cubeRotationAnimationDirection;
+	CubeAxis cubeRotationAnimationAxis;
+	int animatedCubes[NUMBER_OF_CUBES]; // IDs of the cubes of the turning slices
+	int numberOfAnimatedCubes;
 
-	int selectedCubes[NUMBER_OF_ROWS * NUMBER_OF_LAYERS]; // An array containing the IDs (indices) of the selected cubes
-	int selectedRubikSection; // Represents the selected section (0-2)
+	int selectedCubes[MAX_SECTION_CUBES]; // An array containing the IDs (indices) of the selected cubes
+	int selectedRubikSection; // Represents the selected section (0 to GetNumberOfSections(selectedRubikSectionType) - 1)
 	RubikSection selectedRubikSectionType;
 
-	// Given a selected section (the layer or crossLayer param), these methods fill an array (the indices[] param) with 
-	// the IDs of the cubes contained in that section.
-	int* GetRubikLayerCubes(int layer, int indices[]);
-	int* GetRubikHorizontalCrossLayerCubes(int crossLayer, int indices[]);
-	int* GetRubikVerticalCrossLayerCubes(int crossLayer, int indices[]);
+	// Given a selection mode and a selected section, fills an array (the indices[] param) with the IDs of the cubes contained in that section.
+	int* GetRubikSectionCubes(RubikSection sectionType, int section, int indices[]);
 
 	void UnselectAllCubes(); // Sets the isSelected property of all the Cubes to false
 	void SelectCubes(int cubeIndices[], int length); // Sets the isSelected property of the provided Cubes to true
-	void UpdateSelectedCubes(); // Calls the appropriate method for gettting the selected cubes given the values of selectedRubikSection and selectedRubikSectionType. Updates the values of the selectedCubes array
-	void SetSelectedCubesPivot(glm::vec3 pivot);
+	Transformations GetViewTransformations() const; // rubikTransformations with the view frame in its rotation
+
+	void UpdateSelectedCubes(); // Gets the selected cubes given the values of selectedRubikSection and selectedRubikSectionType. Updates the values of the selectedCubes array
+	void TurnCubes(const int cubeIndices[], int numberOfCubes, int rotation); // Turns the resting orientation of the cubes (see CubeRotation)
+	void SetCubesTurnAngle(const int cubeIndices[], int numberOfCubes, CubeAxis axis, float angle);
+	void TurnRubikMatrixSlices(RubikSection sectionType, int firstSlice, int endSlice, int quarterTurns); // Moves the cubes of the slices within rubikMatrix
+
+	static CubeAxis GetRubikSectionAxis(RubikSection section); // Axis around which the cubes of a section rotate
+	static RubikSection GetAxisRubikSection(CubeAxis axis); // Type of the sections that rotate around an axis
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+/*
+	Complete, immutable description of the scene at one simulation step. The simulation (main) thread publishes snapshots through a
+	TripleBuffer and the render thread always draws the latest complete one. A snapshot only holds plain values (no OpenGL objects),
+	so the simulation can produce snapshots without a renderer, e.g. in headless runs.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct CubeSnapshot {
+	glm::mat4 worldMatrix;
+	bool isSelected;
+};
+
+struct RubikSnapshot {
+	const void* id; // Identifies the Rubik's cube across snapshots (used as a cache key by the renderer)
+	unsigned int revision;
+	bool isAnimated;
+	glm::mat4 rotation;
+	glm::vec3 center;
+	float boundingRadius;
+
+	int selectedSection;
+	int selectedSectionType;
+
+	std::vector<CubeSnapshot> cubes;
+};
+
+struct SceneSnapshot {
+	unsigned int step; // Simulation step that produced the snapshot
+
+	int framebufferWidth;
+	int framebufferHeight;
+
+	glm::vec3 cameraPosition;
+	glm::mat4 viewMatrix;
+	glm::mat4 projectionMatrix;
+
+	std::vector<RubikSnapshot> rubiks;
+};
\ No newline at end of file
@@ -0,0 +1,25 @@
+/*
+	Compiler and platform glue for the SIMD kernels. Kernels for x86 instruction sets are compiled in the same translation unit as
+	the portable code and picked at run time (see MoveEngine::DetectInstructionSet), so each one is tagged with its instruction set.
+*/
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need each kernel to be compiled for its instruction set, MSVC accepts the intrinsics anywhere
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_SSE2
+#define TARGET_SSSE3
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
\ No newline at end of file
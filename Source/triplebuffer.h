@@ -0,0 +1,48 @@
+/*
+	A lock-free triple buffer for exactly one writer thread and one reader thread.
+	The writer fills the back buffer and publishes it by swapping it with the middle buffer, the reader takes the latest published
+	buffer by swapping the middle buffer with its front buffer. Neither side ever waits for the other, and the reader always sees a complete buffer.
+*/
+
+#pragma once
+
+#include <atomic>
+
+template <class T>
+class TripleBuffer {
+public:
+	TripleBuffer() : middle(MIDDLE_INDEX_INIT), back(0), front(2) {}
+
+	// Writer side: fill the buffer returned by GetWriteBuffer, then call Publish to make it the latest one
+	T& GetWriteBuffer() { return buffers[back]; }
+
+	void Publish()
+	{
+		back = middle.exchange(back | NEW_DATA_FLAG, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// Reader side: Acquire returns true when a newer buffer was published since the last call.
+	// GetReadBuffer stays valid (and unchanged) until the next call to Acquire.
+	bool Acquire()
+	{
+		if ((middle.load(std::memory_order_relaxed) & NEW_DATA_FLAG) == 0) {
+			return false;
+		}
+
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	const T& GetReadBuffer() const { return buffers[front]; }
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int NEW_DATA_FLAG = 4; // Set in middle when the buffer it refers to has not been read yet
+	static const int MIDDLE_INDEX_INIT = 1;
+
+	T buffers[3];
+
+	alignas(64) std::atomic<int> middle; // Index of the buffer exchanged between the two threads
+	alignas(64) int back; // Only touched by the writer
+	alignas(64) int front; // Only touched by the reader
+};
\ No newline at end of file
@@ -14,6 +14,7 @@ struct Transformations {
 	glm::mat4 translation;
 	glm::mat4 rotation;
 	glm::mat4 scaling;
+	glm::vec3 pivot; // Local point that the rotation turns around
 };
 
 struct Rotation {
@@ -44,6 +45,12 @@ inline void SetUniformVec3(GLuint shader_id, const char* uniform_name, glm::vec3
 	glUniform3fv(glGetUniformLocation(shader_id, uniform_name), 1, glm::value_ptr(uniform_value));
 }
 
+inline void SetUniformVec4(GLuint shader_id, const char* uniform_name, glm::vec4 uniform_value)
+{
+	glUseProgram(shader_id);
+	glUniform4fv(glGetUniformLocation(shader_id, uniform_name), 1, glm::value_ptr(uniform_value));
+}
+
 template <class T>
 inline void SetUniform1Value(GLuint shader_id, const char* uniform_name, T uniform_value)
 {